@@ -7,5 +7,29 @@ namespace gfx
     namespace Config
     {
         constexpr uint32_t FramesInFlight = 2;
+
+        // Size of the persistently mapped buffer all staging uploads are sub-allocated from
+        constexpr uint64_t StagingRingSize = 64 * 1024 * 1024;
+
+        // Per frame in flight size of the linear allocator handing out transient uniform data
+        constexpr uint64_t TransientUniformSize = 4 * 1024 * 1024;
+
+        // Descriptor sets the first pool of a descriptor allocator holds, every further pool doubles up to the maximum
+        constexpr uint32_t DescriptorPoolInitialSets = 64;
+        constexpr uint32_t DescriptorPoolMaxSets = 4096;
+
+        // Textures the bindless texture table can hold, clamped to the device's limits
+        constexpr uint32_t MaxBindlessTextures = 16 * 1024;
+
+        // Upper bounds for a single BindResourceSets() call, lets command buffers bind without heap allocations
+        constexpr uint32_t MaxBoundResourceSets = 8;
+        constexpr uint32_t MaxDynamicOffsets = 16;
+
+        // Emit source level debug info into compiled shaders
+#ifdef NDEBUG
+        constexpr bool ShaderDebugInfo = false;
+#else
+        constexpr bool ShaderDebugInfo = true;
+#endif
     }
 }
@@ -2,6 +2,8 @@
 
 #include "Backend.h"
 
+#include <string>
+
 namespace gfx
 {
     bool Init(const BackendType& backendType, bool enableDebugLayer = false);
@@ -9,4 +11,20 @@ namespace gfx
 
     auto GetBackendType() -> BackendType;
     auto GetBackend() -> Backend*;
+
+    // Directory the pipeline cache is loaded from on Init() and saved to on Shutdown(). Defaults to the working
+    // directory, an empty path disables the on-disk cache. Has to be set before Init().
+    void SetPipelineCachePath(const std::string& path);
+    auto GetPipelineCachePath() -> const std::string&;
+
+    // Directory compiled SPIR-V is cached in, keyed by the hash of each shader stage. Defaults to an empty path,
+    // which keeps the cache in memory only. Has to be set before Init().
+    void SetShaderCachePath(const std::string& path);
+    auto GetShaderCachePath() -> const std::string&;
+
+    // File every distinct pipeline created during the session is recorded in, it is saved on Shutdown() and can be
+    // replayed at startup with PipelineManifest::Replay(). Defaults to an empty path, which disables recording. Has to
+    // be set before Init().
+    void SetPipelineManifestPath(const std::string& path);
+    auto GetPipelineManifestPath() -> const std::string&;
 }
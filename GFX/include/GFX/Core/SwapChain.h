@@ -6,6 +6,7 @@ namespace gfx
 {
     class Window;
     class CommandBuffer;
+    class TransientUniformAllocator;
 
     class SwapChain
     {
@@ -19,6 +20,8 @@ namespace gfx
 
         virtual auto GetFrameIndex() const -> uint32_t = 0;
 
+        virtual auto GetTransientUniforms() -> TransientUniformAllocator& = 0;
+
         virtual void Recreate(uint32_t width, uint32_t height) = 0;
 
         virtual void NewFrame() = 0;
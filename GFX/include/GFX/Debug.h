@@ -21,7 +21,7 @@ namespace gfx
 
     typedef std::function<void(DebugLevel, std::string)> DebugCallbackFn;
 
-    static DebugCallbackFn s_callback;
+    inline DebugCallbackFn s_callback;
 
     void SetDebugCallback(DebugCallbackFn callback);
 
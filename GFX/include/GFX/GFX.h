@@ -16,15 +16,21 @@
 #include "GFX/Resources/Texture.h"
 #include "GFX/Resources/Shader.h"
 #include "GFX/Resources/Pipeline.h"
+#include "GFX/Resources/PipelineManifest.h"
+#include "GFX/Resources/ComputePipeline.h"
 #include "GFX/Resources/ResourceSetLayout.h"
 #include "GFX/Resources/ResourceSet.h"
 #include "GFX/Resources/UniformBuffer.h"
+#include "GFX/Resources/UploadBatch.h"
 
 #include "GFX/Resources/MeshBuilder.h"
 #include "GFX/Resources/MeshImporter.h"
+#include "GFX/Resources/GeometryPool.h"
 
 #include "GFX/Resources/TextureBuilder.h"
 #include "GFX/Resources/TextureImporter.h"
+#include "GFX/Resources/MipGenerator.h"
+#include "GFX/Resources/TextureCompressor.h"
 
 #include "GFX/Resources/Font.h"
 
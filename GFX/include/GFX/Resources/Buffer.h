@@ -10,7 +10,9 @@ namespace gfx
         eStaging,
         eVertex,
         eIndex,
-        eUniform
+        eUniform,
+        eIndirect,
+        eStorage
     };
 
     class Buffer
@@ -21,9 +23,18 @@ namespace gfx
         static auto CreateVertex(size_t size, const void* data = nullptr, bool forceLocalMemory = false) -> OwnedPtr<Buffer>;
         static auto CreateIndex(size_t size, const void* data = nullptr, bool forceLocalMemory = false) -> OwnedPtr<Buffer>;
         static auto CreateUniform(size_t size, const void* data = nullptr) -> OwnedPtr<Buffer>;
+        static auto CreateIndirect(size_t size, const void* data = nullptr, bool forceLocalMemory = false) -> OwnedPtr<Buffer>;
+        static auto CreateStorage(size_t size, const void* data = nullptr, bool forceLocalMemory = false) -> OwnedPtr<Buffer>;
 
         virtual ~Buffer() = default;
 
         virtual void SetData(size_t offset, size_t size, const void* data) = 0;
+
+        // Host visible buffers stay mapped for their whole lifetime, returns nullptr for device local buffers
+        virtual auto GetMappedData() const -> void* = 0;
+
+        // Makes writes through GetMappedData() within the range visible to the device. Only required for non-coherent memory,
+        // SetData() flushes the range it wrote itself.
+        virtual void Flush(size_t offset, size_t size) = 0;
     };
 }
@@ -6,41 +6,152 @@
 #include "Shader.h"
 
 #include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
 
 namespace gfx
 {
     class SwapChain;
     class Framebuffer;
     class Pipeline;
+    class ComputePipeline;
     class Buffer;
     class ResourceSet;
 
+    // Layout matches the GPU's indirect command structures
+    struct DrawIndirectCommand
+    {
+        uint32_t VertexCount = 0;
+        uint32_t InstanceCount = 0;
+        uint32_t FirstVertex = 0;
+        uint32_t FirstInstance = 0;
+    };
+
+    struct DrawIndexedIndirectCommand
+    {
+        uint32_t IndexCount = 0;
+        uint32_t InstanceCount = 0;
+        uint32_t FirstIndex = 0;
+        int32_t VertexOffset = 0;
+        uint32_t FirstInstance = 0;
+    };
+
+    struct DispatchIndirectCommand
+    {
+        uint32_t GroupCountX = 0;
+        uint32_t GroupCountY = 0;
+        uint32_t GroupCountZ = 0;
+    };
+
+    // Where memory is accessed, see CommandBuffer::Barrier()
+    enum class PipelineStage
+    {
+        eTransfer,
+        eIndirect,     // Draw and dispatch commands
+        eVertexInput,  // Vertex and index buffers
+        eVertexShader,
+        ePixelShader,
+        eCompute
+    };
+
+    struct BindCounter
+    {
+        uint32_t Issued = 0;
+        uint32_t Elided = 0;
+    };
+
+    // Binds which matched the already bound state are elided instead of being recorded
+    struct CommandBufferStats
+    {
+        BindCounter Pipeline;
+        BindCounter VertexBuffer;
+        BindCounter IndexBuffer;
+        BindCounter ResourceSets;
+    };
+
     class CommandBuffer
     {
     public:
         static auto Create(uint32_t count = 0) -> OwnedPtr<CommandBuffer>;
+        // Secondary command buffers record part of a render pass, usually on a worker thread, and are executed by a primary
+        // command buffer. Each one owns its command pool, so use one per thread. Begin the primary command buffer before
+        // recording its secondaries, waiting on its frame also makes their previous recording reusable.
+        static auto CreateSecondary(uint32_t count = 0) -> OwnedPtr<CommandBuffer>;
+
+        // Indirect commands may only use a non-zero first instance if this is supported
+        static bool IsDrawIndirectFirstInstanceSupported();
+        // Without it the count draws below ignore the count buffer, see DrawIndirectCount()
+        static bool IsDrawIndirectCountSupported();
 
         virtual ~CommandBuffer() = default;
 
         virtual void Begin() = 0;
+        // Begins a secondary command buffer which continues the render pass of `framebuffer`.
+        // Viewport and scissor are not inherited and have to be set again.
+        virtual void Begin(Framebuffer* framebuffer) = 0;
         virtual void End() = 0;
 
         virtual void SetViewport(const Viewport& viewport) = 0;
         virtual void SetScissor(const Scissor& scissor) = 0;
         virtual void SetLineWidth(float width) = 0;
 
-        virtual void BeginRenderPass(Framebuffer* framebuffer) = 0;
+        // When `secondaryCommandBuffers` is set the render pass may only be filled through ExecuteCommands()
+        virtual void BeginRenderPass(Framebuffer* framebuffer, bool secondaryCommandBuffers = false) = 0;
         virtual void EndRenderPass() = 0;
 
+        // Executes secondary command buffers in the given order
+        virtual void ExecuteCommands(const std::vector<CommandBuffer*>& cmdBuffers) = 0;
+
         virtual void BindPipeline(Pipeline* pipeline) = 0;
+        // Constants and resource sets apply to the kind of pipeline, graphics or compute, which was bound last
+        virtual void BindPipeline(ComputePipeline* pipeline) = 0;
 
         virtual void BindVertexBuffer(Buffer* buffer) = 0;
         virtual void BindIndexBuffer(Buffer* buffer) = 0;
 
         virtual void SetConstants(ShaderStage shaderStage, size_t offset, size_t size, const void* data) = 0;
-        virtual void BindResourceSets(uint32_t firstSet, const std::vector<ResourceSet*> sets) = 0;
+        // One offset per dynamic uniform buffer in `sets`, in set and binding order.
+        // At most Config::MaxBoundResourceSets sets and Config::MaxDynamicOffsets offsets per call.
+        // If an offset is TransientUniformAllocator::InvalidOffset nothing is bound, and draws and dispatches are skipped
+        // until the next successful bind.
+        virtual void BindResourceSets(uint32_t firstSet, std::span<ResourceSet* const> sets, std::span<const uint32_t> dynamicOffsets = {}) = 0;
+        void BindResourceSets(uint32_t firstSet, std::initializer_list<ResourceSet*> sets, std::initializer_list<uint32_t> dynamicOffsets = {})
+        {
+            BindResourceSets(firstSet, std::span(sets.begin(), sets.size()), std::span(dynamicOffsets.begin(), dynamicOffsets.size()));
+        }
 
         virtual void Draw(uint32_t vertexCount) = 0;
         virtual void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t vertexOffset, uint32_t firstInstance) = 0;
+
+        virtual void DrawIndirect(Buffer* buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndirectCommand)) = 0;
+        virtual void DrawIndexedIndirect(Buffer* buffer, size_t offset, uint32_t drawCount, uint32_t stride = sizeof(DrawIndexedIndirectCommand)) = 0;
+        // The draw count is read from `countBuffer` on the GPU, clamped to `maxDrawCount`. Without
+        // IsDrawIndirectCountSupported() all `maxDrawCount` commands are drawn instead, so commands past the count have to
+        // have an instance count of 0.
+        virtual void DrawIndirectCount(Buffer* buffer,
+                                       size_t offset,
+                                       Buffer* countBuffer,
+                                       size_t countOffset,
+                                       uint32_t maxDrawCount,
+                                       uint32_t stride = sizeof(DrawIndirectCommand)) = 0;
+        virtual void DrawIndexedIndirectCount(Buffer* buffer,
+                                              size_t offset,
+                                              Buffer* countBuffer,
+                                              size_t countOffset,
+                                              uint32_t maxDrawCount,
+                                              uint32_t stride = sizeof(DrawIndexedIndirectCommand)) = 0;
+
+        // Dispatches have to be recorded outside of render passes
+        virtual void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) = 0;
+        // Reads a DispatchIndirectCommand from `buffer`
+        virtual void DispatchIndirect(Buffer* buffer, size_t offset = 0) = 0;
+
+        // Makes memory written by `srcStage` visible to `dstStage` and orders later writes after it, e.g.
+        // Barrier(PipelineStage::eCompute, PipelineStage::eIndirect) before drawing with commands written by a compute shader
+        virtual void Barrier(PipelineStage srcStage, PipelineStage dstStage) = 0;
+
+        // Counters cover everything recorded since the last Begin()
+        virtual auto GetStats() const -> const CommandBufferStats& = 0;
     };
 }
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+    class Shader;
+
+    struct ComputePipelineDesc
+    {
+        // Has to be created with only a compute stage, e.g. with Shader::CreateCompute()
+        Shader* Shader = nullptr;
+        // Shader keywords to enable, see Shader::GetVariant()
+        std::vector<std::string> Keywords;
+    };
+
+    class ComputePipeline
+    {
+    public:
+        static auto Create(const ComputePipelineDesc& desc) -> OwnedPtr<ComputePipeline>;
+
+        virtual ~ComputePipeline() = default;
+    };
+}
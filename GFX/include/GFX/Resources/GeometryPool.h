@@ -0,0 +1,61 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+#include "CommandBuffer.h"
+#include "Mesh.h"
+#include "Vertex.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace gfx
+{
+    class Buffer;
+    class UploadBatch;
+    class MeshBuilder;
+    class MeshImporter;
+    struct SubMesh;
+    class FreeListAllocator;
+
+    // Sub-allocates the vertices and indices of many meshes from one vertex and one index buffer, so they can be drawn
+    // without rebinding buffers in between.
+    class GeometryPool
+    {
+    public:
+        static auto Create(uint32_t vertexCapacity = 1024 * 1024, uint32_t indexCapacity = 4 * 1024 * 1024) -> OwnedPtr<GeometryPool>;
+
+        GeometryPool(uint32_t vertexCapacity, uint32_t indexCapacity);
+        ~GeometryPool();
+
+        auto GetVertexBuffer() const -> Buffer* { return m_vertexBuffer.get(); }
+        auto GetIndexBuffer() const -> Buffer* { return m_indexBuffer.get(); }
+
+        // Indices are relative to the first vertex of the mesh. Uploads are recorded into `batch` if one is given,
+        // otherwise they complete before returning. Returns an invalid mesh if the pool is out of space. Non-indexed
+        // geometry passes no indices, its mesh has an IndexCount of 0.
+        auto Allocate(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, UploadBatch* batch = nullptr) -> Mesh;
+        auto Allocate(const MeshBuilder& builder, UploadBatch* batch = nullptr) -> Mesh;
+        auto Allocate(const MeshImporter& importer, UploadBatch* batch = nullptr) -> Mesh;
+
+        void Free(const Mesh& mesh);
+
+        // The part of a mesh allocated from a MeshImporter which belongs to `subMesh`
+        static auto GetSubMesh(const Mesh& mesh, const SubMesh& subMesh) -> Mesh;
+
+        // One indexed draw per sub-mesh, drawing sub-mesh `i` with first instance `i` so shaders can look up per sub-mesh data.
+        // Without CommandBuffer::IsDrawIndirectFirstInstanceSupported() the first instance is 0, shaders then use gl_DrawID,
+        // which is `i` as long as all commands are drawn by one DrawIndexedIndirect() call.
+        static auto BuildIndirectCommands(const Mesh& mesh, const std::vector<SubMesh>& subMeshes) -> std::vector<DrawIndexedIndirectCommand>;
+        static auto CreateIndirectBuffer(const Mesh& mesh, const std::vector<SubMesh>& subMeshes) -> OwnedPtr<Buffer>;
+
+    private:
+        OwnedPtr<Buffer> m_vertexBuffer;
+        OwnedPtr<Buffer> m_indexBuffer;
+
+        OwnedPtr<FreeListAllocator> m_vertexAllocator;
+        OwnedPtr<FreeListAllocator> m_indexAllocator;
+
+        std::mutex m_mutex;
+    };
+}
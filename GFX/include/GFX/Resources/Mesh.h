@@ -1,9 +1,22 @@
 #pragma once
 
+#include <cstdint>
+
 namespace gfx
 {
+    class Buffer;
+
+    // A range of vertices and indices inside the shared buffers of a GeometryPool
     struct Mesh
     {
-        
+        Buffer* VertexBuffer = nullptr;
+        Buffer* IndexBuffer = nullptr;
+
+        uint32_t BaseVertex = 0;
+        uint32_t VertexCount = 0;
+        uint32_t FirstIndex = 0;
+        uint32_t IndexCount = 0;
+
+        bool IsValid() const { return VertexBuffer != nullptr; }
     };
-}
\ No newline at end of file
+}
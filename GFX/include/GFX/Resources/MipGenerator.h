@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace gfx
+{
+    enum class MipFilter
+    {
+        eBox,    // Averages the texels each destination texel covers, cheap and what the GPU blit path does
+        eKaiser  // Kaiser windowed sinc, keeps minified detail sharper at the cost of slight ringing
+    };
+
+    // Downsamples level 0 of `data` on the CPU, independent of any backend so it can also be used by offline tools. Returns
+    // level 0 followed by the generated levels, ready to be passed to Texture::Create() with the same `mips`. Colours of sRGB
+    // formats are filtered in linear space, depth formats are not supported. A `mips` of 0 generates the full chain.
+    auto GenerateMips(const std::vector<uint8_t>& data,
+                      uint32_t width,
+                      uint32_t height,
+                      TextureFormat format,
+                      MipFilter filter = MipFilter::eBox,
+                      uint32_t mips = 0) -> std::vector<uint8_t>;
+}
@@ -3,6 +3,11 @@
 #include "GFX/Core/Base.h"
 #include "VertexLayout.h"
 
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace gfx
 {
     class Framebuffer;
@@ -27,6 +32,8 @@ namespace gfx
     struct PipelineDesc
     {
         Shader* Shader;
+        // Shader keywords to enable, see Shader::GetVariant()
+        std::vector<std::string> Keywords;
         VertexLayout Layout;
         Framebuffer* Framebuffer;
         PrimitiveTopology Topology = PrimitiveTopology::eTriangles;
@@ -41,11 +48,26 @@ namespace gfx
         float DepthBiasSlopeFactor = 1.5f;
     };
 
+    struct PipelineRegistryStats
+    {
+        uint32_t Hits = 0;       // Pipelines which shared an existing identical pipeline
+        uint32_t Misses = 0;     // Pipelines which had to be compiled
+        uint32_t Pipelines = 0;  // Distinct pipelines currently alive
+    };
+
     class Pipeline
     {
     public:
+        // Pipelines with identical descriptions share the same underlying GPU pipeline
         static auto Create(const PipelineDesc& desc) -> OwnedPtr<Pipeline>;
+        // Compiles the pipeline on a worker thread instead of blocking the caller. Until it IsReady(), binding it binds
+        // `placeholder` instead, which has to be usable with the same vertex layout, framebuffer and resource sets. Without
+        // a placeholder binding it waits for the compile. `onReady` is called on the worker thread once it is compiled.
+        static auto CreateAsync(const PipelineDesc& desc, Pipeline* placeholder = nullptr, std::function<void()> onReady = {}) -> OwnedPtr<Pipeline>;
+        static auto GetRegistryStats() -> PipelineRegistryStats;
 
         virtual ~Pipeline() = default;
+
+        virtual bool IsReady() const = 0;
     };
 }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+    class Framebuffer;
+
+    struct PipelineManifestStats
+    {
+        uint32_t Pipelines = 0;  // Pipelines created from the manifest
+        uint32_t Skipped = 0;    // Entries whose shader failed to load or which had no matching framebuffer
+        float Milliseconds = 0;  // Wall time of the whole replay, including loading the shaders
+    };
+
+    // A set of pipelines pre-created from a manifest recorded in an earlier session, see SetPipelineManifestPath()
+    class PipelineManifest
+    {
+    public:
+        // Creates every pipeline recorded in `filename` across worker threads. Shaders are loaded from the files they were
+        // created from, each pipeline targets the first of `framebuffers` with the same attachment formats and sample
+        // count. Pipelines created later from an identical description share the pre-created ones while this is alive.
+        static auto Replay(const std::string& filename, const std::vector<Framebuffer*>& framebuffers) -> OwnedPtr<PipelineManifest>;
+
+        virtual ~PipelineManifest() = default;
+
+        virtual auto GetStats() const -> const PipelineManifestStats& = 0;
+    };
+}
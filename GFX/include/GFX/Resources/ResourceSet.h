@@ -5,6 +5,7 @@
 
 namespace gfx
 {
+    class Buffer;
     class UniformBuffer;
     class Texture;
 
@@ -19,7 +20,13 @@ namespace gfx
         virtual void CopyBindings(const ResourceSet& other) = 0;
 
         virtual void SetUniformBuffer(uint32_t binding, UniformBuffer* buffer) = 0;
+        // `range` is the size of the block the shader sees at each dynamic offset
+        virtual void SetDynamicUniformBuffer(uint32_t binding, Buffer* buffer, size_t range) = 0;
         virtual void SetTextureSampler(uint32_t binding, uint32_t index, Texture* texture) = 0;
+        // A `range` of 0 binds the buffer from `offset` to its end
+        virtual void SetStorageBuffer(uint32_t binding, Buffer* buffer, size_t offset = 0, size_t range = 0) = 0;
+        // `texture` has to be created with TextureUsage::eStorage
+        virtual void SetStorageImage(uint32_t binding, Texture* texture) = 0;
 
         virtual void UpdateBindings() = 0;
     };
@@ -11,7 +11,10 @@ namespace gfx
     {
         eNone = 0,
         eUniformBuffer,
-        eTextureSampler
+        eDynamicUniformBuffer,
+        eTextureSampler,
+        eStorageBuffer,
+        eStorageImage
     };
 
     class ResourceSetLayout
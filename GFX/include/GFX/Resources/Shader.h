@@ -64,7 +64,8 @@ namespace gfx
     {
         eNone = 0,
         eVertex,
-        ePixel
+        ePixel,
+        eCompute
     };
 
     class ShaderResourceDeclaration
@@ -89,17 +90,46 @@ namespace gfx
         uint32_t m_count = 0;
     };
 
+    struct ShaderSources
+    {
+        std::string VertexSource;
+        std::string PixelSource;
+        // Compute shaders only have this stage
+        std::string ComputeSource;
+        // File the sources were loaded from, #include directives are resolved relative to it
+        std::string SourcePath;
+        // Keywords variants of the shader can enable, see Shader::GetVariant()
+        std::vector<std::string> Keywords;
+    };
+
     class Shader
     {
     public:
         static auto Create(const std::string& vertexSource, const std::string& pixelSource) -> OwnedPtr<Shader>;
+        static auto Create(const ShaderSources& sources) -> OwnedPtr<Shader>;
+        static auto CreateCompute(const std::string& computeSource) -> OwnedPtr<Shader>;
+        // Loads a shader file in which each stage starts with a `#type vertex`, `#type pixel` or `#type compute` line.
+        // Keywords are declared on `#keywords A B ...` lines.
+        static auto CreateFromFile(const std::string& filename) -> OwnedPtr<Shader>;
+        // Splits a `#type` shader file into its stages, e.g. to pass them to CreateBatch(). Returns false on failure.
+        static bool LoadSources(const std::string& filename, ShaderSources& sources);
+        // Compiles and reflects every shader across worker threads. Shaders are returned in the order of `sources`.
+        static auto CreateBatch(const std::vector<ShaderSources>& sources) -> std::vector<OwnedPtr<Shader>>;
 
         virtual ~Shader() = default;
 
         virtual auto GetShaderBuffers() const -> const std::unordered_map<std::string, ShaderBuffer>& = 0;
         virtual auto GetShaderResources() const -> const std::unordered_map<std::string, ShaderResourceDeclaration>& = 0;
 
+        virtual auto GetKeywords() const -> const std::vector<std::string>& = 0;
+        // Returns the permutation of this shader with `keywords` enabled. Keywords backed by a bool specialization
+        // constant of the same name, e.g. `layout(constant_id = 0) const bool USE_FOG = false;`, share this shader's
+        // SPIR-V and are only applied when a pipeline is created from PipelineDesc::Keywords. Any other keyword is
+        // passed as a #define, its variant is compiled on first request and kept for the lifetime of this shader.
+        virtual auto GetVariant(const std::vector<std::string>& keywords) -> Shader* = 0;
+
         auto AllocateResourceSet(uint32_t frameIndex, uint32_t set) -> OwnedPtr<ResourceSet>;
+        // Resource sets can be bound with any shader whose `set` has the same bindings, not just the one they were created from
         auto CreateResourceSet(uint32_t set) -> OwnedPtr<ResourceSet>;
 
     protected:
@@ -4,8 +4,13 @@
 #include "TextureBuilder.h"
 #include "TextureImporter.h"
 
+#include <algorithm>
+#include <cstdint>
+
 namespace gfx
 {
+    class UploadBatch;
+
     enum class WrapMode
     {
         eRepeat = 0,
@@ -25,10 +30,20 @@ namespace gfx
         eNone,
         eR,
         eRGBA,
+        eRGBA16f,
 
         eDepth32f,
         eDepth24Stencil8,
 
+        // Block compressed: the data of each level is 4x4 texel blocks stored row by row. Any width and height is allowed,
+        // a level of w x h texels holds ((w + 3) / 4) x ((h + 3) / 4) blocks and the texels past its edge are padding.
+        // CompressTexture() encodes all of them from eRGBA or eR data, the device needs textureCompressionBC to sample them.
+        eBC1,  // RGB sRGB, 8 bytes per block. Always the four colour mode, without 1-bit alpha.
+        eBC3,  // RGBA sRGB, 16 bytes per block. A BC1 colour block and a BC4 alpha block.
+        eBC4,  // R unorm, 8 bytes per block
+        eBC5,  // RG unorm, 16 bytes per block. Two BC4 blocks, e.g. for normal maps.
+        eBC7,  // RGBA sRGB, 16 bytes per block. Higher quality than eBC3, the encoder only produces mode 6.
+
         // default depth
         eDepth = eDepth24Stencil8
     };
@@ -37,7 +52,25 @@ namespace gfx
     {
         eNone = 0,
         eTexture,
-        eAttachment
+        eAttachment,
+        // Written by compute shaders, kept in the general layout so it can also be sampled without transitions.
+        // Needs a format the device supports as a storage image: eRGBA16f always is, eR may be and eRGBA (sRGB) and the
+        // depth and block compressed formats are not.
+        eStorage
+    };
+
+    // Textures with the same sampler state share one sampler
+    struct SamplerDesc
+    {
+        WrapMode WrapU = WrapMode::eRepeat;
+        WrapMode WrapV = WrapMode::eRepeat;
+        WrapMode WrapW = WrapMode::eRepeat;
+        FilterMode MinFilter = FilterMode::eLinear;
+        FilterMode MagFilter = FilterMode::eLinear;
+        FilterMode MipFilter = FilterMode::eLinear;
+        float MaxAnisotropy = 1.0f;  // Values above 1 enable anisotropic filtering, clamped to the device limit
+
+        bool operator==(const SamplerDesc&) const = default;
     };
 
     struct TextureDesc
@@ -46,27 +79,104 @@ namespace gfx
         uint32_t Height = 0;
         uint32_t Depth = 1;
         uint32_t Layers = 1;
-        uint32_t Mips = 1;
+        uint32_t Mips = 1;  // 0 creates the full chain down to 1x1
         TextureFormat Format;
         TextureUsage Usage;
+        SamplerDesc Sampler{};
     };
 
     class Texture
     {
     public:
-        static auto Create(const TextureBuilder& builder) -> OwnedPtr<Texture>;
-        static auto Create(const TextureImporter& importer) -> OwnedPtr<Texture>;
-        static auto Create(const TextureDesc& desc, const std::vector<uint8_t>& data = {}) -> OwnedPtr<Texture>;
+        // With a `batch` the pixel data is only recorded into it, so loading many textures and meshes takes a single
+        // submission. The texture can be bound right away but not sampled, nor destroyed, before the batch was flushed
+        // or its fence completed. Without one the data is uploaded before returning.
+        static auto Create(const TextureBuilder& builder, const SamplerDesc& sampler = {}, UploadBatch* batch = nullptr) -> OwnedPtr<Texture>;
+        static auto Create(const TextureImporter& importer, const SamplerDesc& sampler = {}, UploadBatch* batch = nullptr) -> OwnedPtr<Texture>;
+        // `data` holds the first levels tightly packed, see CalculateTextureSize(). The remaining levels are generated on the GPU
+        // from the last level given.
+        static auto Create(const TextureDesc& desc, const std::vector<uint8_t>& data = {}, UploadBatch* batch = nullptr) -> OwnedPtr<Texture>;
+
+        // Whether the device supports indexing textures through the global texture table, see GetBindlessIndex()
+        static bool IsBindlessSupported();
 
         virtual ~Texture() = default;
 
         virtual auto GetWidth() const -> uint32_t = 0;
         virtual auto GetHeight() const -> uint32_t = 0;
         virtual auto GetFormat() const -> TextureFormat = 0;
+        virtual auto GetMipCount() const -> uint32_t = 0;
+        virtual auto GetSamplerDesc() const -> const SamplerDesc& = 0;
+
+        // Stable index of the texture in the global texture table, which shaders declare as a runtime sized sampler array
+        // alone in its set, e.g. `layout(set = 2, binding = 0) uniform sampler2D Textures[];`. The texture is registered on
+        // the first call and its index is freed again when it is destroyed.
+        virtual auto GetBindlessIndex() -> uint32_t = 0;
     };
 
     inline bool IsDepthFormat(TextureFormat format)
     {
         return format == TextureFormat::eDepth32f || format == TextureFormat::eDepth24Stencil8;
     }
+
+    inline bool IsCompressedFormat(TextureFormat format)
+    {
+        return format == TextureFormat::eBC1 || format == TextureFormat::eBC3 || format == TextureFormat::eBC4 || format == TextureFormat::eBC5 ||
+               format == TextureFormat::eBC7;
+    }
+
+    // Bytes per texel, 0 for block compressed formats
+    inline auto GetFormatSize(TextureFormat format) -> uint32_t
+    {
+        switch (format)
+        {
+            case TextureFormat::eR: return 1;
+            case TextureFormat::eRGBA: return 4;
+            case TextureFormat::eRGBA16f: return 8;
+            case TextureFormat::eDepth32f: return 4;
+            case TextureFormat::eDepth24Stencil8: return 4;
+            case TextureFormat::eNone:
+            default: break;
+        }
+        return 0;
+    }
+
+    // Bytes per 4x4 block of block compressed formats, 0 for others
+    inline auto GetBlockSize(TextureFormat format) -> uint32_t
+    {
+        switch (format)
+        {
+            case TextureFormat::eBC1:
+            case TextureFormat::eBC4: return 8;
+            case TextureFormat::eBC3:
+            case TextureFormat::eBC5:
+            case TextureFormat::eBC7: return 16;
+            default: break;
+        }
+        return 0;
+    }
+
+    // Levels of the full mip chain down to 1x1
+    inline auto CalculateMipCount(uint32_t width, uint32_t height) -> uint32_t
+    {
+        uint32_t mips = 1;
+        for (auto size = std::max(width, height); size > 1; size /= 2) mips++;
+        return mips;
+    }
+
+    // Bytes of the first `mips` levels tightly packed one after another, the layout texture data is uploaded in
+    inline auto CalculateTextureSize(uint32_t width, uint32_t height, TextureFormat format, uint32_t mips = 1) -> size_t
+    {
+        size_t size = 0;
+        for (uint32_t mip = 0; mip < mips; mip++)
+        {
+            const auto mipWidth = std::max(width >> mip, 1u);
+            const auto mipHeight = std::max(height >> mip, 1u);
+            if (IsCompressedFormat(format))
+                size += size_t((mipWidth + 3) / 4) * ((mipHeight + 3) / 4) * GetBlockSize(format);
+            else
+                size += size_t(mipWidth) * mipHeight * GetFormatSize(format);
+        }
+        return size;
+    }
 }
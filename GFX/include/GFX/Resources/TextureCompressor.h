@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace gfx
+{
+    enum class CompressionQuality
+    {
+        eFast,    // Endpoints from the bounding box of each block, for iteration or runtime compression
+        eNormal,  // Endpoints along each block's principal axis, refined once
+        eHigh     // Refines further and searches more encodings per block, for offline cooking
+    };
+
+    // Block compresses `mips` levels of `data` on the CPU across worker threads, independent of any backend so it can be run
+    // at import time or by offline tools. `data` holds the levels tightly packed in `format`, which has to be eRGBA or eR,
+    // e.g. the result of GenerateMips(). `compressedFormat` is one of the block compressed formats: eBC4 stores the red
+    // channel and eBC5 red and green. Returns the compressed levels in the same layout, ready for Texture::Create().
+    auto CompressTexture(const std::vector<uint8_t>& data,
+                         uint32_t width,
+                         uint32_t height,
+                         TextureFormat format,
+                         TextureFormat compressedFormat,
+                         CompressionQuality quality = CompressionQuality::eNormal,
+                         uint32_t mips = 1) -> std::vector<uint8_t>;
+}
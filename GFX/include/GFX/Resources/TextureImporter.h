@@ -6,6 +6,7 @@
 namespace gfx
 {
     enum class TextureFormat;
+    enum class CompressionQuality;
 
     class TextureImporter
     {
@@ -21,6 +22,9 @@ namespace gfx
 
         auto GetData() const -> const std::vector<uint8_t>& { return m_data; }
 
+        // Replaces the image with its full mip chain block compressed to `format`, so it is uploaded as is
+        void Compress(TextureFormat format, CompressionQuality quality);
+
     private:
         void Load(const std::string& filename);
 
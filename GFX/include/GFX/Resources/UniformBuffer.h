@@ -3,7 +3,9 @@
 #include "GFX/Core/Base.h"
 #include "Shader.h"
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <map>
 
 namespace gfx
@@ -43,4 +45,52 @@ namespace gfx
         // frames->set->binding
         std::map<uint32_t, std::map<uint32_t, std::map<uint32_t, OwnedPtr<UniformBuffer>>>> m_uniformBuffers;
     };
+
+    // Linear allocator for uniform data which only lives for a single frame. Every frame in flight owns a region of one
+    // persistently mapped buffer, which is reset by SwapChain::NewFrame(). Bind the buffer with ResourceSet::SetDynamicUniformBuffer()
+    // and pass the returned offsets to CommandBuffer::BindResourceSets().
+    class TransientUniformAllocator
+    {
+    public:
+        static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+        struct Allocation
+        {
+            uint32_t Offset = InvalidOffset;
+            void* Data = nullptr;  // Null once the frame's region is exhausted
+
+            explicit operator bool() const { return Data != nullptr; }
+        };
+
+        TransientUniformAllocator(size_t sizePerFrame, size_t alignment, uint32_t frames);
+
+        auto GetBuffer() const -> Buffer* { return m_buffer.get(); }
+
+        // Thread-safe. Fails once the frame's region is exhausted, check the allocation before writing to it.
+        auto Allocate(size_t size) -> Allocation;
+
+        // Returns InvalidOffset if the data did not fit, the draw using it should be skipped
+        template <typename T>
+        auto Push(const T& data) -> uint32_t
+        {
+            const auto allocation = Allocate(sizeof(T));
+            if (!allocation) return InvalidOffset;
+
+            std::memcpy(allocation.Data, &data, sizeof(T));
+            return allocation.Offset;
+        }
+
+        void Reset(uint32_t frameIndex);
+        void Flush();
+
+    private:
+        OwnedPtr<Buffer> m_buffer;
+        uint8_t* m_mapped = nullptr;
+
+        size_t m_alignment;
+        size_t m_frameSize;
+        size_t m_frameOffset = 0;
+        std::atomic<size_t> m_head = 0;
+        std::atomic<bool> m_overflowReported = false;
+    };
 }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace gfx
+{
+    class Buffer;
+    class Texture;
+
+    class UploadFence
+    {
+    public:
+        virtual ~UploadFence() = default;
+
+        virtual bool IsComplete() const = 0;
+        virtual void Wait() const = 0;
+    };
+
+    class UploadBatch
+    {
+    public:
+        static auto Create() -> OwnedPtr<UploadBatch>;
+
+        virtual ~UploadBatch() = default;
+
+        virtual void Upload(Buffer* buffer, size_t offset, size_t size, const void* data) = 0;
+        // `data` holds one or more levels, the texture's remaining levels are generated from them
+        virtual void Upload(Texture* texture, const std::vector<uint8_t>& data) = 0;
+
+        // Records every pending copy into a single command buffer, submits it and waits for it to complete
+        virtual void Flush() = 0;
+
+        // Submits every pending copy on the transfer queue without waiting. The uploaded resources are ready once the
+        // returned fence is complete. Returns nullptr if there was nothing to upload.
+        virtual auto Submit() -> SharedPtr<UploadFence> = 0;
+    };
+}
@@ -91,6 +91,9 @@ namespace gfx
         VertexLayout(std::initializer_list<VertexElement> elements)
             : m_elements(elements) { CalculateOffsetAndStride(); }
 
+        VertexLayout(std::vector<VertexElement> elements)
+            : m_elements(std::move(elements)) { CalculateOffsetAndStride(); }
+
         auto GetStride() const -> uint32_t { return m_stride; }
         auto GetElements() const -> const std::vector<VertexElement>& { return m_elements; }
         auto GetElementCount() const -> uint32_t { return (uint32_t)m_elements.size(); }
@@ -7,6 +7,9 @@ namespace gfx
     bool s_initialised = false;
     BackendType s_backendType = BackendType::eNone;
     OwnedPtr<Backend> s_backend = nullptr;
+    std::string s_pipelineCachePath = ".";
+    std::string s_shaderCachePath;
+    std::string s_pipelineManifestPath;
 
     bool Init(const BackendType& backendType, bool enableDebugLayer)
     {
@@ -49,4 +52,34 @@ namespace gfx
     {
         return s_backend.get();
     }
+
+    void SetPipelineCachePath(const std::string& path)
+    {
+        s_pipelineCachePath = path;
+    }
+
+    auto GetPipelineCachePath() -> const std::string&
+    {
+        return s_pipelineCachePath;
+    }
+
+    void SetShaderCachePath(const std::string& path)
+    {
+        s_shaderCachePath = path;
+    }
+
+    auto GetShaderCachePath() -> const std::string&
+    {
+        return s_shaderCachePath;
+    }
+
+    void SetPipelineManifestPath(const std::string& path)
+    {
+        s_pipelineManifestPath = path;
+    }
+
+    auto GetPipelineManifestPath() -> const std::string&
+    {
+        return s_pipelineManifestPath;
+    }
 }
@@ -48,11 +48,13 @@ namespace gfx
         }
     }
 
-    void VulkanAllocator::Allocate(vk::BufferCreateInfo imageInfo, VmaMemoryUsage memoryUsage, vk::Buffer* buffer, VmaAllocation* allocation)
+    void VulkanAllocator::Allocate(vk::BufferCreateInfo imageInfo, VmaMemoryUsage memoryUsage, vk::Buffer* buffer, VmaAllocation* allocation, void** mappedData)
     {
         {
             VmaAllocationCreateInfo allocInfo{};
             allocInfo.usage = memoryUsage;
+            // Keep the allocation persistently mapped for the lifetime of the buffer
+            if (mappedData != nullptr) allocInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
             VkBufferCreateInfo rawBufferInfo = imageInfo;
 
@@ -63,6 +65,7 @@ namespace gfx
         {
             VmaAllocationInfo allocInfo;
             vmaGetAllocationInfo(m_allocator, *allocation, &allocInfo);
+            if (mappedData != nullptr) *mappedData = allocInfo.pMappedData;
 
             GFX_TRACE("VulkanAllocator: Buffer allocated. Size = {}", allocInfo.size);
         }
@@ -100,4 +103,9 @@ namespace gfx
     }
 
     void VulkanAllocator::Unmap(VmaAllocation allocation) { vmaUnmapMemory(m_allocator, allocation); }
+
+    void VulkanAllocator::Flush(VmaAllocation allocation, const vk::DeviceSize offset, const vk::DeviceSize size)
+    {
+        vmaFlushAllocation(m_allocator, allocation, offset, size);
+    }
 }
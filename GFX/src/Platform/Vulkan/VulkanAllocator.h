@@ -18,7 +18,7 @@ namespace gfx
         ~VulkanAllocator();
 
         void Allocate(vk::ImageCreateInfo imageInfo, VmaMemoryUsage memoryUsage, vk::Image* image, VmaAllocation* allocation);
-        void Allocate(vk::BufferCreateInfo imageInfo, VmaMemoryUsage memoryUsage, vk::Buffer* buffer, VmaAllocation* allocation);
+        void Allocate(vk::BufferCreateInfo imageInfo, VmaMemoryUsage memoryUsage, vk::Buffer* buffer, VmaAllocation* allocation, void** mappedData = nullptr);
 
         void Free(vk::Image& image, VmaAllocation& allocation);
         void Free(vk::Buffer& buffer, VmaAllocation& allocation);
@@ -26,6 +26,9 @@ namespace gfx
         auto Map(VmaAllocation allocation) -> void*;
         void Unmap(VmaAllocation allocation);
 
+        // Flushes a range of host visible, non-coherent memory. Coherent memory is left untouched.
+        void Flush(VmaAllocation allocation, vk::DeviceSize offset, vk::DeviceSize size);
+
     private:
         VmaAllocator m_allocator;
 
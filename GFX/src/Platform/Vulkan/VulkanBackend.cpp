@@ -1,5 +1,6 @@
 #include "VulkanBackend.h"
 
+#include "GFX/Config.h"
 #include "GFX/Debug.h"
 
 #include <string>
@@ -42,6 +43,14 @@ namespace gfx
         PickPhysicalDevice();
         CreateDevice();
         CreateAllocator();
+        CreateStagingRing();
+        CreatePipelineCache();
+        CreatePipelineRegistry();
+        CreatePipelineManifestRecorder();
+        CreateLayoutCache();
+        CreateSamplerCache();
+        CreateTextureTable();
+        CreateShaderCache();
     }
 
     VulkanBackend::~VulkanBackend() {}
@@ -107,4 +116,23 @@ namespace gfx
 
     void VulkanBackend::CreateAllocator() { m_allocator = CreateOwned<VulkanAllocator>(m_instance, m_physicalDevice->GetHandle(), m_device->GetHandle()); }
 
+    void VulkanBackend::CreateStagingRing() { m_stagingRing = CreateOwned<VulkanStagingRing>(*m_device, *m_allocator, Config::StagingRingSize); }
+
+    void VulkanBackend::CreatePipelineCache() { m_pipelineCache = CreateOwned<VulkanPipelineCache>(*m_device, *m_physicalDevice, GetPipelineCachePath()); }
+
+    void VulkanBackend::CreatePipelineRegistry() { m_pipelineRegistry = CreateOwned<VulkanPipelineRegistry>(); }
+
+    void VulkanBackend::CreatePipelineManifestRecorder()
+    {
+        m_pipelineManifestRecorder = CreateOwned<VulkanPipelineManifestRecorder>(GetPipelineManifestPath());
+    }
+
+    void VulkanBackend::CreateLayoutCache() { m_layoutCache = CreateOwned<VulkanLayoutCache>(); }
+
+    void VulkanBackend::CreateSamplerCache() { m_samplerCache = CreateOwned<VulkanSamplerCache>(*m_device, *m_physicalDevice); }
+
+    void VulkanBackend::CreateTextureTable() { m_textureTable = CreateOwned<VulkanTextureTable>(*m_device, *m_physicalDevice); }
+
+    void VulkanBackend::CreateShaderCache() { m_shaderCache = CreateOwned<VulkanShaderCache>(GetShaderCachePath()); }
+
 }  // namespace gfx
@@ -7,6 +7,14 @@
 #include "VulkanDevice.h"
 #include "VulkanPhysicalDevice.h"
 #include "VulkanAllocator.h"
+#include "VulkanStagingRing.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanPipelineRegistry.h"
+#include "VulkanPipelineManifest.h"
+#include "VulkanLayoutCache.h"
+#include "VulkanSamplerCache.h"
+#include "VulkanTextureTable.h"
+#include "VulkanShaderCache.h"
 
 #include <vulkan/vulkan.hpp>
 
@@ -24,6 +32,14 @@ namespace gfx
         auto GetPhysicalDevice() -> VulkanPhysicalDevice& { return *m_physicalDevice; }
         auto GetDevice() -> VulkanDevice& { return *m_device; }
         auto GetAllocator() -> VulkanAllocator& { return *m_allocator; }
+        auto GetStagingRing() -> VulkanStagingRing& { return *m_stagingRing; }
+        auto GetPipelineCache() -> VulkanPipelineCache& { return *m_pipelineCache; }
+        auto GetPipelineRegistry() -> VulkanPipelineRegistry& { return *m_pipelineRegistry; }
+        auto GetPipelineManifestRecorder() -> VulkanPipelineManifestRecorder& { return *m_pipelineManifestRecorder; }
+        auto GetLayoutCache() -> VulkanLayoutCache& { return *m_layoutCache; }
+        auto GetSamplerCache() -> VulkanSamplerCache& { return *m_samplerCache; }
+        auto GetTextureTable() -> VulkanTextureTable& { return *m_textureTable; }
+        auto GetShaderCache() -> VulkanShaderCache& { return *m_shaderCache; }
 
         void WaitIdle() override;
 
@@ -32,6 +48,14 @@ namespace gfx
         void PickPhysicalDevice();
         void CreateDevice();
         void CreateAllocator();
+        void CreateStagingRing();
+        void CreatePipelineCache();
+        void CreatePipelineRegistry();
+        void CreatePipelineManifestRecorder();
+        void CreateLayoutCache();
+        void CreateSamplerCache();
+        void CreateTextureTable();
+        void CreateShaderCache();
 
     private:
         vk::Instance m_instance;
@@ -40,5 +64,13 @@ namespace gfx
         OwnedPtr<VulkanPhysicalDevice> m_physicalDevice;
         OwnedPtr<VulkanDevice> m_device;
         OwnedPtr<VulkanAllocator> m_allocator;
+        OwnedPtr<VulkanStagingRing> m_stagingRing;
+        OwnedPtr<VulkanPipelineCache> m_pipelineCache;
+        OwnedPtr<VulkanPipelineRegistry> m_pipelineRegistry;
+        OwnedPtr<VulkanPipelineManifestRecorder> m_pipelineManifestRecorder;
+        OwnedPtr<VulkanLayoutCache> m_layoutCache;
+        OwnedPtr<VulkanSamplerCache> m_samplerCache;
+        OwnedPtr<VulkanTextureTable> m_textureTable;
+        OwnedPtr<VulkanShaderCache> m_shaderCache;
     };
 }
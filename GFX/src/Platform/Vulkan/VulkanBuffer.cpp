@@ -1,7 +1,12 @@
 #include "VulkanBuffer.h"
 
+#include "GFX/Debug.h"
+
 #include "VulkanBackend.h"
 #include "VulkanAllocator.h"
+#include "VulkanUploadBatch.h"
+
+#include <cstring>
 
 namespace gfx
 {
@@ -14,9 +19,12 @@ namespace gfx
                 default:
                 case BufferUsage::eNone: break;
                 case BufferUsage::eStaging: return vk::BufferUsageFlagBits::eTransferSrc;
-                case BufferUsage::eVertex: return vk::BufferUsageFlagBits::eVertexBuffer;
-                case BufferUsage::eIndex: return vk::BufferUsageFlagBits::eIndexBuffer;
+                // Geometry and draw commands can be written by compute shaders, e.g. for skinning and GPU culling
+                case BufferUsage::eVertex: return vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+                case BufferUsage::eIndex: return vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
                 case BufferUsage::eUniform: return vk::BufferUsageFlagBits::eUniformBuffer;
+                case BufferUsage::eIndirect: return vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+                case BufferUsage::eStorage: return vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc;
             }
             return {};
         }
@@ -29,7 +37,9 @@ namespace gfx
                 case BufferUsage::eNone: break;
                 case BufferUsage::eStaging: return VMA_MEMORY_USAGE_CPU_ONLY;
                 case BufferUsage::eVertex:
-                case BufferUsage::eIndex: return VMA_MEMORY_USAGE_GPU_ONLY;
+                case BufferUsage::eIndex:
+                case BufferUsage::eIndirect:
+                case BufferUsage::eStorage: return VMA_MEMORY_USAGE_GPU_ONLY;
                 case BufferUsage::eUniform: return VMA_MEMORY_USAGE_CPU_TO_GPU;
             }
             return {};
@@ -48,14 +58,24 @@ namespace gfx
         if (usage != BufferUsage::eStaging) vkUsage |= vk::BufferUsageFlagBits::eTransferDst;
 
         auto memUsage = Utils::ToMemUsage(usage);
-        if (m_forceLocalMemory && (usage == BufferUsage::eVertex || usage == BufferUsage::eIndex))
+        if (m_forceLocalMemory && (usage == BufferUsage::eVertex || usage == BufferUsage::eIndex || usage == BufferUsage::eIndirect ||
+                                   usage == BufferUsage::eStorage))
             memUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
 
         vk::BufferCreateInfo bufferInfo{};
         bufferInfo.setSize(m_size);
         bufferInfo.setUsage(vkUsage);
 
-        allocator.Allocate(bufferInfo, memUsage, &m_buffer, &m_allocation);
+        if (IsHostVisible())
+        {
+            void* mapped = nullptr;
+            allocator.Allocate(bufferInfo, memUsage, &m_buffer, &m_allocation, &mapped);
+            m_mapped = static_cast<uint8_t*>(mapped);
+        }
+        else
+        {
+            allocator.Allocate(bufferInfo, memUsage, &m_buffer, &m_allocation);
+        }
 
         if (data != nullptr)
         {
@@ -71,32 +91,32 @@ namespace gfx
         allocator.Free(m_buffer, m_allocation);
     }
 
-    void VulkanBuffer::SetData(const size_t, const size_t size, const void* data)
+    bool VulkanBuffer::IsHostVisible() const { return m_forceLocalMemory || m_usage == BufferUsage::eStaging || m_usage == BufferUsage::eUniform; }
+
+    void VulkanBuffer::SetData(const size_t offset, const size_t size, const void* data)
     {
-        auto* backend = VulkanBackend::Get();
-        auto& allocator = backend->GetAllocator();
+        GFX_ASSERT(offset + size <= m_size, "SetData() exceeds buffer size!");
 
-        if (m_forceLocalMemory || m_usage == BufferUsage::eStaging || m_usage == BufferUsage::eUniform)
+        if (IsHostVisible())
         {
             // Direct copy
-            auto* mapped = allocator.Map(m_allocation);
-            std::memcpy(mapped, data, size);
-            allocator.Unmap(m_allocation);
+            std::memcpy(m_mapped + offset, data, size);
+            Flush(offset, size);
         }
         else
         {
-            // Staging buffer
-            const auto stagingBuffer = CreateStaging(size, data);
-            auto* vkStagingBuffer = static_cast<VulkanBuffer*>(stagingBuffer.get());
+            // Staging ring
+            VulkanUploadBatch batch;
+            batch.Upload(this, offset, size, data);
+            batch.Flush();
+        }
+    }
 
-            vk::BufferCopy copyRegion{};
-            copyRegion.setSize(size);
+    void VulkanBuffer::Flush(const size_t offset, const size_t size)
+    {
+        if (m_mapped == nullptr) return;
 
-            auto& device = backend->GetDevice();
-            const auto cmdBuffer = device.GetCommandBuffer(true);
-            cmdBuffer.copyBuffer(vkStagingBuffer->GetHandle(), m_buffer, copyRegion);
-            device.FlushCommandBuffer(cmdBuffer);
-        }
+        VulkanBackend::Get()->GetAllocator().Flush(m_allocation, offset, size);
     }
 
     auto VulkanBuffer::GetBufferInfo() const -> vk::DescriptorBufferInfo
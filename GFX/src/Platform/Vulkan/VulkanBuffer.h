@@ -19,8 +19,13 @@ namespace gfx
 
         auto GetHandle() const -> vk::Buffer { return m_buffer; }
 
+        bool IsHostVisible() const;
+
         void SetData(size_t offset, size_t size, const void* data) override;
 
+        auto GetMappedData() const -> void* override { return m_mapped; }
+        void Flush(size_t offset, size_t size) override;
+
         auto GetBufferInfo() const -> vk::DescriptorBufferInfo;
 
     private:
@@ -30,5 +35,6 @@ namespace gfx
 
         vk::Buffer m_buffer;
         VmaAllocation m_allocation;
+        uint8_t* m_mapped = nullptr;
     };
 }
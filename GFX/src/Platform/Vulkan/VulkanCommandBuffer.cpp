@@ -3,19 +3,75 @@
 #include "GFX/Debug.h"
 
 #include "GFX/Config.h"
+#include "GFX/Resources/UniformBuffer.h"
 #include "VulkanBackend.h"
 #include "VulkanDevice.h"
 #include "VulkanFramebuffer.h"
 #include "VulkanPipeline.h"
+#include "VulkanComputePipeline.h"
 #include "VulkanBuffer.h"
 #include "VulkanResourceSet.h"
 #include "VulkanUtils.h"
 
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <vector>
 
 namespace gfx
 {
-    VulkanCommandBuffer::VulkanCommandBuffer(uint32_t count)
+    static_assert(sizeof(DrawIndirectCommand) == sizeof(vk::DrawIndirectCommand));
+    static_assert(sizeof(DrawIndexedIndirectCommand) == sizeof(vk::DrawIndexedIndirectCommand));
+    static_assert(sizeof(DispatchIndirectCommand) == sizeof(vk::DispatchIndirectCommand));
+
+    namespace Utils
+    {
+        auto ToVkPipelineStage(PipelineStage stage) -> vk::PipelineStageFlags
+        {
+            switch (stage)
+            {
+                case PipelineStage::eTransfer: return vk::PipelineStageFlagBits::eTransfer;
+                case PipelineStage::eIndirect: return vk::PipelineStageFlagBits::eDrawIndirect;
+                case PipelineStage::eVertexInput: return vk::PipelineStageFlagBits::eVertexInput;
+                case PipelineStage::eVertexShader: return vk::PipelineStageFlagBits::eVertexShader;
+                case PipelineStage::ePixelShader: return vk::PipelineStageFlagBits::eFragmentShader;
+                case PipelineStage::eCompute: return vk::PipelineStageFlagBits::eComputeShader;
+            }
+            return {};
+        }
+
+        auto ToVkWriteAccess(PipelineStage stage) -> vk::AccessFlags
+        {
+            switch (stage)
+            {
+                case PipelineStage::eTransfer: return vk::AccessFlagBits::eTransferWrite;
+                case PipelineStage::eVertexShader:
+                case PipelineStage::ePixelShader:
+                case PipelineStage::eCompute: return vk::AccessFlagBits::eShaderWrite;
+                case PipelineStage::eIndirect:
+                case PipelineStage::eVertexInput: break;
+            }
+            return {};
+        }
+
+        auto ToVkReadAccess(PipelineStage stage) -> vk::AccessFlags
+        {
+            switch (stage)
+            {
+                case PipelineStage::eTransfer: return vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite;
+                case PipelineStage::eIndirect: return vk::AccessFlagBits::eIndirectCommandRead;
+                case PipelineStage::eVertexInput: return vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead;
+                case PipelineStage::eVertexShader:
+                case PipelineStage::ePixelShader:
+                case PipelineStage::eCompute:
+                    return vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+            }
+            return {};
+        }
+    }
+
+    VulkanCommandBuffer::VulkanCommandBuffer(uint32_t count, bool secondary)
+        : m_secondary(secondary)
     {
         auto* backend = VulkanBackend::Get();
         auto& gpu = backend->GetPhysicalDevice();
@@ -33,7 +89,7 @@ namespace gfx
 
         vk::CommandBufferAllocateInfo allocInfo{};
         allocInfo.setCommandPool(m_cmdPool);
-        allocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+        allocInfo.setLevel(m_secondary ? vk::CommandBufferLevel::eSecondary : vk::CommandBufferLevel::ePrimary);
         allocInfo.setCommandBufferCount(count);
 
         m_cmdBuffers = vkDevice.allocateCommandBuffers(allocInfo);
@@ -61,6 +117,31 @@ namespace gfx
     }
 
     void VulkanCommandBuffer::Begin()
+    {
+        GFX_ASSERT(!m_secondary, "Secondary command buffers have to be begun with a framebuffer!");
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        Begin(beginInfo);
+    }
+
+    void VulkanCommandBuffer::Begin(Framebuffer* framebuffer)
+    {
+        GFX_ASSERT(m_secondary, "Only secondary command buffers can continue a render pass!");
+
+        const auto renderPassInfo = static_cast<VulkanFramebuffer*>(framebuffer)->GetBeginInfo();
+
+        vk::CommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.setRenderPass(renderPassInfo.renderPass);
+        inheritanceInfo.setSubpass(0);
+        inheritanceInfo.setFramebuffer(renderPassInfo.framebuffer);
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+        beginInfo.setPInheritanceInfo(&inheritanceInfo);
+        Begin(beginInfo);
+    }
+
+    void VulkanCommandBuffer::Begin(const vk::CommandBufferBeginInfo& beginInfo)
     {
         auto* backend = VulkanBackend::Get();
         auto& device = backend->GetDevice();
@@ -68,12 +149,30 @@ namespace gfx
         m_currentCmdBuffer = m_cmdBuffers[m_index];
         m_currentFence = m_fences[m_index];
 
-        device.WaitForFence(m_currentFence);
-
-        device.ResetFence(m_currentFence);
+        // Secondary command buffers are never submitted themselves, the primary executing them guards their reuse
+        if (!m_secondary)
+        {
+            device.WaitForFence(m_currentFence);
+            device.ResetFence(m_currentFence);
+        }
 
-        vk::CommandBufferBeginInfo beginInfo{};
         m_currentCmdBuffer.begin(beginInfo);
+
+        ResetState();
+        m_stats = {};
+    }
+
+    void VulkanCommandBuffer::ResetState()
+    {
+        m_bindPoint = vk::PipelineBindPoint::eGraphics;
+        m_boundComputePipelineHandle = nullptr;
+        m_boundPipelineHandle = nullptr;
+        m_boundLayout = nullptr;
+        m_boundVertexBuffer = nullptr;
+        m_boundIndexBuffer = nullptr;
+        m_boundSets.fill(nullptr);
+        m_dynamicSetCount = 0;
+        m_skipDraws = false;
     }
 
     void VulkanCommandBuffer::End()
@@ -112,10 +211,11 @@ namespace gfx
         m_currentCmdBuffer.setLineWidth(width);
     }
 
-    void VulkanCommandBuffer::BeginRenderPass(Framebuffer* framebuffer)
+    void VulkanCommandBuffer::BeginRenderPass(Framebuffer* framebuffer, bool secondaryCommandBuffers)
     {
         auto* vkFramebuffer = static_cast<VulkanFramebuffer*>(framebuffer);
-        m_currentCmdBuffer.beginRenderPass(vkFramebuffer->GetBeginInfo(), vk::SubpassContents::eInline);
+        const auto contents = secondaryCommandBuffers ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline;
+        m_currentCmdBuffer.beginRenderPass(vkFramebuffer->GetBeginInfo(), contents);
     }
 
     void VulkanCommandBuffer::EndRenderPass()
@@ -123,55 +223,314 @@ namespace gfx
         m_currentCmdBuffer.endRenderPass();
     }
 
-    void VulkanCommandBuffer::BindPipeline(Pipeline* pipeline)
+    void VulkanCommandBuffer::ExecuteCommands(const std::vector<CommandBuffer*>& cmdBuffers)
+    {
+        std::vector<vk::CommandBuffer> vkCmdBuffers;
+        vkCmdBuffers.reserve(cmdBuffers.size());
+        for (auto* cmdBuffer : cmdBuffers)
+        {
+            auto* vkCmdBuffer = static_cast<VulkanCommandBuffer*>(cmdBuffer);
+            GFX_ASSERT(vkCmdBuffer->m_secondary, "Only secondary command buffers can be executed!");
+            vkCmdBuffers.push_back(vkCmdBuffer->GetHandle());
+        }
+
+        if (!vkCmdBuffers.empty()) m_currentCmdBuffer.executeCommands(vkCmdBuffers);
+
+        // Bound state is undefined after executing secondary command buffers
+        ResetState();
+    }
+
+    auto VulkanCommandBuffer::GetBoundLayout() const -> vk::PipelineLayout
     {
-        auto* vkPipeline = static_cast<VulkanPipeline*>(pipeline);
-        m_currentCmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, vkPipeline->GetPipelineHandle());
+        if (m_bindPoint == vk::PipelineBindPoint::eCompute) return m_boundComputePipeline->GetLayoutHandle();
+        return m_boundPipeline->GetLayoutHandle();
+    }
 
+    void VulkanCommandBuffer::BindPipeline(Pipeline* pipeline)
+    {
+        // Pipelines still compiling in the background are swapped for their placeholder
+        auto* vkPipeline = static_cast<VulkanPipeline*>(pipeline)->Resolve();
         m_boundPipeline = vkPipeline;
+        m_bindPoint = vk::PipelineBindPoint::eGraphics;
+
+        const auto handle = vkPipeline->GetPipelineHandle();
+        if (handle == m_boundPipelineHandle)
+        {
+            m_stats.Pipeline.Elided++;
+            return;
+        }
+
+        m_currentCmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, handle);
+        m_boundPipelineHandle = handle;
+        m_stats.Pipeline.Issued++;
+
+        const auto& layout = vkPipeline->GetLayout();
+        if (&layout != m_boundLayout)
+        {
+            // Layouts are interned, so sets up to the first differing set layout stay bound. Sets after it get disturbed,
+            // so stop treating them as bound
+            const auto compatible = m_boundLayout != nullptr ? layout.GetCompatibleSetCount(*m_boundLayout) : 0;
+            m_boundLayout = &layout;
+            std::fill(m_boundSets.begin() + compatible, m_boundSets.end(), nullptr);
+            if (m_dynamicFirstSet + m_dynamicSetCount > compatible)
+                m_dynamicSetCount = 0;
+
+            BindTextureTable(vk::PipelineBindPoint::eGraphics, layout);
+        }
+    }
+
+    void VulkanCommandBuffer::BindPipeline(ComputePipeline* pipeline)
+    {
+        auto* vkPipeline = static_cast<VulkanComputePipeline*>(pipeline);
+        m_boundComputePipeline = vkPipeline;
+        m_bindPoint = vk::PipelineBindPoint::eCompute;
+
+        const auto handle = vkPipeline->GetPipelineHandle();
+        if (handle == m_boundComputePipelineHandle)
+        {
+            m_stats.Pipeline.Elided++;
+            return;
+        }
+
+        m_currentCmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, handle);
+        m_boundComputePipelineHandle = handle;
+        m_stats.Pipeline.Issued++;
+
+        BindTextureTable(vk::PipelineBindPoint::eCompute, vkPipeline->GetLayout());
+    }
+
+    void VulkanCommandBuffer::BindTextureTable(vk::PipelineBindPoint bindPoint, const VulkanPipelineLayout& layout)
+    {
+        auto& textureTable = VulkanBackend::Get()->GetTextureTable();
+        const auto& setLayouts = layout.SetLayouts;
+        const auto it = std::find(setLayouts.begin(), setLayouts.end(), textureTable.GetLayout());
+        if (it == setLayouts.end()) return;
+
+        const auto set = uint32_t(std::distance(setLayouts.begin(), it));
+        const auto handle = textureTable.GetHandle();
+        if (bindPoint == vk::PipelineBindPoint::eGraphics)
+        {
+            // Stays bound across every pipeline whose layout is compatible up to the table's set
+            if (m_boundSets[set] == handle)
+            {
+                m_stats.ResourceSets.Elided++;
+                return;
+            }
+
+            m_boundSets[set] = handle;
+            if (set >= m_dynamicFirstSet && set < m_dynamicFirstSet + m_dynamicSetCount) m_dynamicSetCount = 0;
+        }
+
+        m_currentCmdBuffer.bindDescriptorSets(bindPoint, layout.Handle, set, handle, {});
+        m_stats.ResourceSets.Issued++;
     }
 
     void VulkanCommandBuffer::BindVertexBuffer(Buffer* buffer)
     {
-        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
-        m_currentCmdBuffer.bindVertexBuffers(0, vkBuffer->GetHandle(), { 0 });
+        const auto handle = static_cast<VulkanBuffer*>(buffer)->GetHandle();
+        if (handle == m_boundVertexBuffer)
+        {
+            m_stats.VertexBuffer.Elided++;
+            return;
+        }
+
+        m_currentCmdBuffer.bindVertexBuffers(0, handle, { 0 });
+        m_boundVertexBuffer = handle;
+        m_stats.VertexBuffer.Issued++;
     }
 
     void VulkanCommandBuffer::BindIndexBuffer(Buffer* buffer)
     {
-        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
-        m_currentCmdBuffer.bindIndexBuffer(vkBuffer->GetHandle(), { 0 }, vk::IndexType::eUint32);
+        const auto handle = static_cast<VulkanBuffer*>(buffer)->GetHandle();
+        if (handle == m_boundIndexBuffer)
+        {
+            m_stats.IndexBuffer.Elided++;
+            return;
+        }
+
+        m_currentCmdBuffer.bindIndexBuffer(handle, { 0 }, vk::IndexType::eUint32);
+        m_boundIndexBuffer = handle;
+        m_stats.IndexBuffer.Issued++;
     }
 
     void VulkanCommandBuffer::SetConstants(ShaderStage shaderStage, size_t offset, size_t size, const void* data)
     {
-        auto layout = m_boundPipeline->GetLayoutHandle();
+        auto layout = GetBoundLayout();
         auto stage = VkUtils::ToVkShaderStage(shaderStage);
 
         m_currentCmdBuffer.pushConstants(layout, stage, (uint32_t)offset, (uint32_t)size, data);
     }
 
-    void VulkanCommandBuffer::BindResourceSets(uint32_t firstSet, const std::vector<ResourceSet*> sets)
+    void VulkanCommandBuffer::BindResourceSets(uint32_t firstSet, std::span<ResourceSet* const> sets, std::span<const uint32_t> dynamicOffsets)
     {
-        auto layout = m_boundPipeline->GetLayoutHandle();
+        GFX_ASSERT(firstSet + sets.size() <= Config::MaxBoundResourceSets, "Too many resource sets bound!");
+        GFX_ASSERT(dynamicOffsets.size() <= Config::MaxDynamicOffsets, "Too many dynamic offsets!");
+
+        // A failed transient allocation would make the GPU read past the buffer. Nothing is bound and draws are skipped until
+        // the next successful bind, rather than drawing with the sets and offsets of the previous object.
+        m_skipDraws = std::find(dynamicOffsets.begin(), dynamicOffsets.end(), TransientUniformAllocator::InvalidOffset) != dynamicOffsets.end();
+        GFX_ASSERT(!m_skipDraws, "Binding resource sets with an invalid dynamic offset, the transient uniform allocator overflowed!");
+        if (m_skipDraws) return;
 
-        std::vector<vk::DescriptorSet> vkSets;
-        vkSets.resize(sets.size());
-        for (int i = 0; i < sets.size(); i++)
+        const auto setCount = uint32_t(sets.size());
+
+        std::array<vk::DescriptorSet, Config::MaxBoundResourceSets> vkSets;
+        bool bound = true;
+        for (uint32_t i = 0; i < setCount; i++)
         {
             vkSets[i] = static_cast<VulkanResourceSet*>(sets[i])->GetHandle();
+            bound &= vkSets[i] == m_boundSets[firstSet + i];
+        }
+
+        // Compute passes bind few sets, only the graphics bindings are tracked
+        if (m_bindPoint == vk::PipelineBindPoint::eCompute)
+        {
+            m_currentCmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                                  GetBoundLayout(),
+                                                  firstSet,
+                                                  setCount,
+                                                  vkSets.data(),
+                                                  uint32_t(dynamicOffsets.size()),
+                                                  dynamicOffsets.data());
+            m_stats.ResourceSets.Issued++;
+            return;
         }
 
-        m_currentCmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, firstSet, vkSets, {});
+        if (bound && !dynamicOffsets.empty())
+        {
+            bound = m_dynamicFirstSet == firstSet && m_dynamicSetCount == setCount &&
+                    std::equal(dynamicOffsets.begin(), dynamicOffsets.end(), m_dynamicOffsets.begin(), m_dynamicOffsets.begin() + m_dynamicOffsetCount);
+        }
+
+        if (bound)
+        {
+            m_stats.ResourceSets.Elided++;
+            return;
+        }
+
+        auto layout = m_boundPipeline->GetLayoutHandle();
+        m_currentCmdBuffer.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics, layout, firstSet, setCount, vkSets.data(), uint32_t(dynamicOffsets.size()), dynamicOffsets.data());
+        m_stats.ResourceSets.Issued++;
+
+        std::copy_n(vkSets.begin(), setCount, m_boundSets.begin() + firstSet);
+        if (!dynamicOffsets.empty())
+        {
+            m_dynamicFirstSet = firstSet;
+            m_dynamicSetCount = setCount;
+            m_dynamicOffsetCount = uint32_t(dynamicOffsets.size());
+            std::copy(dynamicOffsets.begin(), dynamicOffsets.end(), m_dynamicOffsets.begin());
+        }
+        else if (firstSet < m_dynamicFirstSet + m_dynamicSetCount && m_dynamicFirstSet < firstSet + setCount)
+        {
+            m_dynamicSetCount = 0;
+        }
     }
 
     void VulkanCommandBuffer::Draw(uint32_t vertexCount)
     {
+        if (m_skipDraws) return;
+
         m_currentCmdBuffer.draw(vertexCount, 1, 0, 0);
     }
 
     void VulkanCommandBuffer::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t vertexOffset, uint32_t firstInstance)
     {
+        if (m_skipDraws) return;
+
         m_currentCmdBuffer.drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
     }
+
+    void VulkanCommandBuffer::DrawIndirect(Buffer* buffer, size_t offset, uint32_t drawCount, uint32_t stride)
+    {
+        if (m_skipDraws) return;
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+
+        if (VulkanBackend::Get()->GetPhysicalDevice().GetFeatures().multiDrawIndirect)
+        {
+            m_currentCmdBuffer.drawIndirect(vkBuffer->GetHandle(), offset, drawCount, stride);
+            return;
+        }
+
+        // Without multi-draw support every command needs its own call
+        for (uint32_t i = 0; i < drawCount; i++)
+            m_currentCmdBuffer.drawIndirect(vkBuffer->GetHandle(), offset + size_t(i) * stride, 1, stride);
+    }
+
+    void VulkanCommandBuffer::DrawIndexedIndirect(Buffer* buffer, size_t offset, uint32_t drawCount, uint32_t stride)
+    {
+        if (m_skipDraws) return;
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+
+        if (VulkanBackend::Get()->GetPhysicalDevice().GetFeatures().multiDrawIndirect)
+        {
+            m_currentCmdBuffer.drawIndexedIndirect(vkBuffer->GetHandle(), offset, drawCount, stride);
+            return;
+        }
+
+        // Without multi-draw support every command needs its own call
+        for (uint32_t i = 0; i < drawCount; i++)
+            m_currentCmdBuffer.drawIndexedIndirect(vkBuffer->GetHandle(), offset + size_t(i) * stride, 1, stride);
+    }
+
+    void VulkanCommandBuffer::DrawIndirectCount(Buffer* buffer, size_t offset, Buffer* countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride)
+    {
+        if (m_skipDraws) return;
+
+        // Commands past the count are expected to draw no instances, so drawing all of them gives the same result
+        if (!VulkanBackend::Get()->GetPhysicalDevice().GetFeatures12().drawIndirectCount)
+        {
+            DrawIndirect(buffer, offset, maxDrawCount, stride);
+            return;
+        }
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+        auto* vkCountBuffer = static_cast<VulkanBuffer*>(countBuffer);
+        m_currentCmdBuffer.drawIndirectCount(vkBuffer->GetHandle(), offset, vkCountBuffer->GetHandle(), countOffset, maxDrawCount, stride);
+    }
+
+    void VulkanCommandBuffer::DrawIndexedIndirectCount(
+        Buffer* buffer, size_t offset, Buffer* countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride)
+    {
+        if (m_skipDraws) return;
+
+        if (!VulkanBackend::Get()->GetPhysicalDevice().GetFeatures12().drawIndirectCount)
+        {
+            DrawIndexedIndirect(buffer, offset, maxDrawCount, stride);
+            return;
+        }
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+        auto* vkCountBuffer = static_cast<VulkanBuffer*>(countBuffer);
+        m_currentCmdBuffer.drawIndexedIndirectCount(vkBuffer->GetHandle(), offset, vkCountBuffer->GetHandle(), countOffset, maxDrawCount, stride);
+    }
+
+    void VulkanCommandBuffer::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+    {
+        GFX_ASSERT(m_bindPoint == vk::PipelineBindPoint::eCompute, "Bind a compute pipeline before dispatching!");
+        if (m_skipDraws) return;
+
+        m_currentCmdBuffer.dispatch(groupCountX, groupCountY, groupCountZ);
+    }
+
+    void VulkanCommandBuffer::DispatchIndirect(Buffer* buffer, size_t offset)
+    {
+        GFX_ASSERT(m_bindPoint == vk::PipelineBindPoint::eCompute, "Bind a compute pipeline before dispatching!");
+        if (m_skipDraws) return;
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+        m_currentCmdBuffer.dispatchIndirect(vkBuffer->GetHandle(), offset);
+    }
+
+    void VulkanCommandBuffer::Barrier(PipelineStage srcStage, PipelineStage dstStage)
+    {
+        // A global memory barrier covers buffers and storage images alike, storage images never leave the general layout
+        vk::MemoryBarrier barrier{};
+        barrier.setSrcAccessMask(Utils::ToVkWriteAccess(srcStage));
+        barrier.setDstAccessMask(Utils::ToVkReadAccess(dstStage));
+
+        m_currentCmdBuffer.pipelineBarrier(Utils::ToVkPipelineStage(srcStage), Utils::ToVkPipelineStage(dstStage), {}, barrier, {}, {});
+    }
 }
@@ -1,9 +1,11 @@
 ﻿#pragma once
 
+#include "GFX/Config.h"
 #include "GFX/Resources/CommandBuffer.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -12,38 +14,66 @@ namespace gfx
     class SwapChain;
     class Pipeline;
     class VulkanPipeline;
+    class VulkanComputePipeline;
+    struct VulkanPipelineLayout;
 
     class VulkanCommandBuffer : public CommandBuffer
     {
     public:
-        VulkanCommandBuffer(uint32_t count = 0);
+        VulkanCommandBuffer(uint32_t count = 0, bool secondary = false);
         ~VulkanCommandBuffer() override;
 
         auto GetHandle() const -> vk::CommandBuffer { return m_currentCmdBuffer; }
         auto GetFence() const -> vk::Fence { return m_currentFence; }
 
         void Begin() override;
+        void Begin(Framebuffer* framebuffer) override;
         void End() override;
 
         void SetViewport(const Viewport& viewport) override;
         void SetScissor(const Scissor& scissor) override;
         void SetLineWidth(float width) override;
 
-        void BeginRenderPass(Framebuffer* framebuffer) override;
+        void BeginRenderPass(Framebuffer* framebuffer, bool secondaryCommandBuffers) override;
         void EndRenderPass() override;
 
+        void ExecuteCommands(const std::vector<CommandBuffer*>& cmdBuffers) override;
+
         void BindPipeline(Pipeline* pipeline) override;
+        void BindPipeline(ComputePipeline* pipeline) override;
 
         void BindVertexBuffer(Buffer* buffer) override;
         void BindIndexBuffer(Buffer* buffer) override;
 
         void SetConstants(ShaderStage shaderStage, size_t offset, size_t size, const void* data) override;
-        void BindResourceSets(uint32_t firstSet, const std::vector<ResourceSet*> sets) override;
+        using CommandBuffer::BindResourceSets;
+        void BindResourceSets(uint32_t firstSet, std::span<ResourceSet* const> sets, std::span<const uint32_t> dynamicOffsets) override;
 
         void Draw(uint32_t vertexCount) override;
         void DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t vertexOffset, uint32_t firstInstance) override;
 
+        void DrawIndirect(Buffer* buffer, size_t offset, uint32_t drawCount, uint32_t stride) override;
+        void DrawIndexedIndirect(Buffer* buffer, size_t offset, uint32_t drawCount, uint32_t stride) override;
+        void DrawIndirectCount(Buffer* buffer, size_t offset, Buffer* countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride) override;
+        void DrawIndexedIndirectCount(Buffer* buffer, size_t offset, Buffer* countBuffer, size_t countOffset, uint32_t maxDrawCount, uint32_t stride) override;
+
+        void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void DispatchIndirect(Buffer* buffer, size_t offset) override;
+
+        void Barrier(PipelineStage srcStage, PipelineStage dstStage) override;
+
+        auto GetStats() const -> const CommandBufferStats& override { return m_stats; }
+
+    private:
+        void Begin(const vk::CommandBufferBeginInfo& beginInfo);
+        void ResetState();
+        auto GetBoundLayout() const -> vk::PipelineLayout;
+        // Binds the global texture table if `layout` declares it
+        void BindTextureTable(vk::PipelineBindPoint bindPoint, const VulkanPipelineLayout& layout);
+
     private:
+        bool m_secondary = false;
+
         vk::CommandPool m_cmdPool;
         std::vector<vk::CommandBuffer> m_cmdBuffers;
         std::vector<vk::Fence> m_fences;
@@ -53,6 +83,25 @@ namespace gfx
         vk::Fence m_currentFence;
 
         /* State */
-        VulkanPipeline* m_boundPipeline;
+        vk::PipelineBindPoint m_bindPoint = vk::PipelineBindPoint::eGraphics;
+        VulkanPipeline* m_boundPipeline = nullptr;
+        VulkanComputePipeline* m_boundComputePipeline = nullptr;
+        vk::Pipeline m_boundComputePipelineHandle;
+        vk::Pipeline m_boundPipelineHandle;
+        const VulkanPipelineLayout* m_boundLayout = nullptr;  // Graphics only
+        vk::Buffer m_boundVertexBuffer;
+        vk::Buffer m_boundIndexBuffer;
+        std::array<vk::DescriptorSet, Config::MaxBoundResourceSets> m_boundSets{};  // Graphics only
+
+        // Dynamic offsets of the last bind which used them, they cannot be attributed to individual sets
+        uint32_t m_dynamicFirstSet = 0;
+        uint32_t m_dynamicSetCount = 0;
+        uint32_t m_dynamicOffsetCount = 0;
+        std::array<uint32_t, Config::MaxDynamicOffsets> m_dynamicOffsets{};
+
+        // Set when the last BindResourceSets() got an invalid dynamic offset, draws and dispatches are dropped until a bind succeeds
+        bool m_skipDraws = false;
+
+        CommandBufferStats m_stats{};
     };
 }
@@ -0,0 +1,54 @@
+#include "VulkanComputePipeline.h"
+
+#include "GFX/Debug.h"
+
+#include "VulkanBackend.h"
+#include "VulkanDevice.h"
+#include "VulkanShader.h"
+
+#include <chrono>
+#include <vector>
+
+namespace gfx
+{
+    VulkanComputePipeline::VulkanComputePipeline(const ComputePipelineDesc& desc)
+        : m_desc(desc)
+    {
+        auto* backend = VulkanBackend::Get();
+        auto vkDevice = backend->GetDevice().GetHandle();
+
+        auto* vkShader = static_cast<VulkanShader*>(desc.Shader->GetVariant(desc.Keywords));
+        GFX_ASSERT(vkShader->IsCompute(), "Compute pipelines need a compute shader!");
+
+        m_layout = vkShader->GetPipelineLayout();
+
+        std::vector<vk::SpecializationMapEntry> specializationEntries;
+        std::vector<vk::Bool32> specializationData;
+        vkShader->GetSpecializationData(m_desc.Keywords, specializationEntries, specializationData);
+
+        vk::SpecializationInfo specializationInfo{};
+        specializationInfo.setMapEntries(specializationEntries);
+        specializationInfo.setData<vk::Bool32>(specializationData);
+
+        auto shaderStage = vkShader->GetShaderStageCreateInfos().front();
+        if (!specializationEntries.empty()) shaderStage.setPSpecializationInfo(&specializationInfo);
+
+        vk::ComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.setLayout(m_layout->Handle);
+        pipelineInfo.setStage(shaderStage);
+
+        auto& pipelineCache = backend->GetPipelineCache();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        m_pipeline = vkDevice.createComputePipeline(pipelineCache.GetHandle(), pipelineInfo).value;
+        pipelineCache.RecordCreation(std::chrono::high_resolution_clock::now() - start);
+    }
+
+    VulkanComputePipeline::~VulkanComputePipeline()
+    {
+        auto* backend = VulkanBackend::Get();
+        auto vkDevice = backend->GetDevice().GetHandle();
+
+        vkDevice.destroy(m_pipeline);
+    }
+}
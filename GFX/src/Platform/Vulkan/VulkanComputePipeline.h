@@ -0,0 +1,26 @@
+#pragma once
+
+#include "GFX/Resources/ComputePipeline.h"
+#include "VulkanLayoutCache.h"
+
+#include <vulkan/vulkan.hpp>
+
+namespace gfx
+{
+    class VulkanComputePipeline : public ComputePipeline
+    {
+    public:
+        VulkanComputePipeline(const ComputePipelineDesc& desc);
+        ~VulkanComputePipeline();
+
+        auto GetPipelineHandle() -> vk::Pipeline { return m_pipeline; }
+        auto GetLayoutHandle() -> vk::PipelineLayout { return m_layout->Handle; }
+        auto GetLayout() const -> const VulkanPipelineLayout& { return *m_layout; }
+
+    private:
+        ComputePipelineDesc m_desc;
+
+        SharedPtr<const VulkanPipelineLayout> m_layout;
+        vk::Pipeline m_pipeline;
+    };
+}
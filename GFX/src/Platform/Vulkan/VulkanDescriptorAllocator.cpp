@@ -0,0 +1,163 @@
+#include "VulkanDescriptorAllocator.h"
+
+#include "GFX/Config.h"
+#include "GFX/Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        // Descriptors per set the first pool is sized for, before any usage has been observed
+        constexpr std::pair<vk::DescriptorType, float> DefaultPoolRatios[] = {
+            { vk::DescriptorType::eUniformBuffer, 2.0f },
+            { vk::DescriptorType::eUniformBufferDynamic, 1.0f },
+            { vk::DescriptorType::eCombinedImageSampler, 4.0f },
+            { vk::DescriptorType::eStorageBuffer, 1.0f },
+            { vk::DescriptorType::eStorageImage, 1.0f },
+        };
+
+        // Later pools get this much more of each type than the average set used so far, in case the mix shifts
+        constexpr double PoolSizeHeadroom = 1.5;
+    }
+
+    VulkanDescriptorAllocator::VulkanDescriptorAllocator(vk::Device device)
+        : m_device(device),
+          m_setsPerPool(Config::DescriptorPoolInitialSets)
+    {
+    }
+
+    VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+    {
+        for (const auto& pool : m_pools)
+        {
+            m_device.destroy(pool);
+        }
+    }
+
+    auto VulkanDescriptorAllocator::Allocate(const VulkanDescriptorSetLayout& layout) -> vk::DescriptorSet
+    {
+        std::lock_guard lock(m_mutex);
+
+        // Layouts are interned, and a free set keeps its layout and so its handle alive
+        auto& freeSets = m_freeSets[VkDescriptorSetLayout(layout.Handle)];
+        if (!freeSets.empty())
+        {
+            const auto set = freeSets.back().Set;
+            freeSets.pop_back();
+            return set;
+        }
+
+        m_allocatedSets++;
+        for (const auto& size : layout.PoolSizes)
+        {
+            m_allocatedDescriptors[size.type] += size.descriptorCount;
+        }
+
+        // Pools are sized to fit at least one set of the layout, so allocating from a new pool cannot fail
+        bool newPool = m_pools.empty();
+        if (newPool) m_pools.push_back(CreatePool(layout));
+
+        while (true)
+        {
+            vk::DescriptorSetAllocateInfo allocInfo{};
+            allocInfo.setDescriptorPool(m_pools[m_currentPool]);
+            allocInfo.setDescriptorSetCount(1);
+            allocInfo.setSetLayouts(layout.Handle);
+
+            vk::DescriptorSet set;
+            const auto result = m_device.allocateDescriptorSets(&allocInfo, &set);
+            if (result == vk::Result::eSuccess) return set;
+
+            if (newPool || (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool))
+            {
+                GFX_ERROR("Failed to allocate descriptor set: {}", vk::to_string(result));
+                return {};
+            }
+
+            // Move on to the next pool, creating a larger one once all of them are exhausted
+            newPool = ++m_currentPool == m_pools.size();
+            if (newPool)
+            {
+                m_setsPerPool = std::min(m_setsPerPool * 2, Config::DescriptorPoolMaxSets);
+                m_pools.push_back(CreatePool(layout));
+            }
+        }
+    }
+
+    void VulkanDescriptorAllocator::Free(SharedPtr<const VulkanDescriptorSetLayout> layout, vk::DescriptorSet set)
+    {
+        std::lock_guard lock(m_mutex);
+        m_releasedSets[m_frameIndex].push_back({ std::move(layout), set });
+    }
+
+    void VulkanDescriptorAllocator::NewFrame(uint32_t frameIndex)
+    {
+        std::lock_guard lock(m_mutex);
+
+        // The last frame which could have used these sets has finished, so has every frame before it which freed a set
+        auto& released = m_releasedSets[frameIndex];
+        for (auto& freeSet : released)
+        {
+            const VkDescriptorSetLayout handle = freeSet.Layout->Handle;
+            m_freeSets[handle].push_back(std::move(freeSet));
+        }
+        released.clear();
+
+        m_frameIndex = frameIndex;
+    }
+
+    void VulkanDescriptorAllocator::Reset()
+    {
+        std::lock_guard lock(m_mutex);
+
+        for (const auto& pool : m_pools)
+        {
+            m_device.resetDescriptorPool(pool);
+        }
+        m_currentPool = 0;
+        m_freeSets.clear();
+        for (auto& released : m_releasedSets)
+        {
+            released.clear();
+        }
+    }
+
+    auto VulkanDescriptorAllocator::CreatePool(const VulkanDescriptorSetLayout& layout) -> vk::DescriptorPool
+    {
+        std::vector<vk::DescriptorPoolSize> poolSizes;
+        if (m_pools.empty())
+        {
+            for (const auto& [type, ratio] : Utils::DefaultPoolRatios)
+            {
+                poolSizes.emplace_back(type, uint32_t(ratio * float(m_setsPerPool)));
+            }
+        }
+        else
+        {
+            for (const auto& [type, count] : m_allocatedDescriptors)
+            {
+                const auto perSet = double(count) / double(m_allocatedSets);
+                poolSizes.emplace_back(type, uint32_t(std::ceil(perSet * Utils::PoolSizeHeadroom * m_setsPerPool)));
+            }
+        }
+
+        // Whatever the observed mix, the set being allocated has to fit
+        for (const auto& size : layout.PoolSizes)
+        {
+            auto it = std::find_if(poolSizes.begin(), poolSizes.end(), [&](const auto& poolSize) { return poolSize.type == size.type; });
+            if (it == poolSizes.end()) it = poolSizes.insert(it, vk::DescriptorPoolSize(size.type, 0));
+            it->descriptorCount = std::max(it->descriptorCount, size.descriptorCount);
+        }
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.setPoolSizes(poolSizes);
+        poolInfo.setMaxSets(m_setsPerPool);
+
+        GFX_TRACE("Creating descriptor pool {} for {} sets.", m_pools.size(), m_setsPerPool);
+        return m_device.createDescriptorPool(poolInfo);
+    }
+}
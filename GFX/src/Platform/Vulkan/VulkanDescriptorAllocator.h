@@ -0,0 +1,61 @@
+#pragma once
+
+#include "VulkanLayoutCache.h"
+#include "GFX/Config.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx
+{
+    // Allocates descriptor sets from a growing chain of pools. Once every pool is exhausted a larger one is created, sized
+    // from the mix of descriptor types allocated so far. Freed sets are handed out again to layouts with the same bindings,
+    // once the frame they were freed in has finished on the GPU.
+    class VulkanDescriptorAllocator
+    {
+    public:
+        VulkanDescriptorAllocator(vk::Device device);
+        ~VulkanDescriptorAllocator();
+
+        auto Allocate(const VulkanDescriptorSetLayout& layout) -> vk::DescriptorSet;
+        // The set is only handed out again once the frame it was freed in has finished. Its layout is kept alive until then,
+        // so the set is never reused after the layout it was allocated with has been destroyed.
+        void Free(SharedPtr<const VulkanDescriptorSetLayout> layout, vk::DescriptorSet set);
+        // The GPU has finished `frameIndex`, the sets freed while it was recorded can be handed out again
+        void NewFrame(uint32_t frameIndex);
+
+        // Returns every set at once, the pools are kept for the next allocations
+        void Reset();
+
+    private:
+        struct FreeSet
+        {
+            SharedPtr<const VulkanDescriptorSetLayout> Layout;
+            vk::DescriptorSet Set;
+        };
+
+    private:
+        auto CreatePool(const VulkanDescriptorSetLayout& layout) -> vk::DescriptorPool;
+
+    private:
+        vk::Device m_device;
+
+        std::mutex m_mutex;
+        std::vector<vk::DescriptorPool> m_pools;
+        size_t m_currentPool = 0;
+        uint32_t m_setsPerPool = 0;
+
+        std::unordered_map<VkDescriptorSetLayout, std::vector<FreeSet>> m_freeSets;  // Layout -> sets
+        std::array<std::vector<FreeSet>, Config::FramesInFlight> m_releasedSets;    // Per frame they were freed in
+        uint32_t m_frameIndex = 0;
+
+        // Usage observed so far, pools after the first are sized from it
+        uint64_t m_allocatedSets = 0;
+        std::unordered_map<vk::DescriptorType, uint64_t> m_allocatedDescriptors;
+    };
+}
@@ -1,5 +1,7 @@
 #include "VulkanDevice.h"
 
+#include "Utility/Hash.h"
+
 #include <vector>
 
 namespace gfx
@@ -21,15 +23,34 @@ namespace gfx
         features.fillModeNonSolid = true;
         features.wideLines = true;
         features.samplerAnisotropy = true;
+        features.textureCompressionBC = m_physicalDevice.GetFeatures().textureCompressionBC;
         features.shaderSampledImageArrayDynamicIndexing = true;
+        features.multiDrawIndirect = m_physicalDevice.GetFeatures().multiDrawIndirect;
+        features.drawIndirectFirstInstance = m_physicalDevice.GetFeatures().drawIndirectFirstInstance;
 
         deviceInfo.setPEnabledFeatures(&features);
 
+        // gl_DrawID identifies draws of a multi-draw without relying on drawIndirectFirstInstance
+        vk::PhysicalDeviceVulkan11Features features11{};
+        features11.shaderDrawParameters = m_physicalDevice.GetFeatures11().shaderDrawParameters;
+
+        vk::PhysicalDeviceVulkan12Features features12{};
+        features12.drawIndirectCount = m_physicalDevice.GetFeatures12().drawIndirectCount;
+        // Descriptor indexing for the bindless texture table, it is only created if all of them are supported
+        features12.runtimeDescriptorArray = m_physicalDevice.GetFeatures12().runtimeDescriptorArray;
+        features12.shaderSampledImageArrayNonUniformIndexing = m_physicalDevice.GetFeatures12().shaderSampledImageArrayNonUniformIndexing;
+        features12.descriptorBindingPartiallyBound = m_physicalDevice.GetFeatures12().descriptorBindingPartiallyBound;
+        features12.descriptorBindingSampledImageUpdateAfterBind = m_physicalDevice.GetFeatures12().descriptorBindingSampledImageUpdateAfterBind;
+        features12.descriptorBindingUpdateUnusedWhilePending = m_physicalDevice.GetFeatures12().descriptorBindingUpdateUnusedWhilePending;
+
+        features11.setPNext(&features12);
+        deviceInfo.setPNext(&features11);
+
         m_device = m_physicalDevice.GetHandle().createDevice(deviceInfo);
 
         auto queueFamilyIndices = m_physicalDevice.GetQueueFamilyIndices();
         m_graphicsQueue = m_device.getQueue(queueFamilyIndices.Graphics, 0);
-        //        m_transferQueue = m_device.getQueue(m_transferQueueFamily, 0);
+        m_transferQueue = m_device.getQueue(queueFamilyIndices.Transfer, 0);
 
         {
             vk::CommandPoolCreateInfo poolInfo{};
@@ -40,29 +61,17 @@ namespace gfx
         }
 
         {
-            std::vector<vk::DescriptorPoolSize> poolSizes = {
-                { vk::DescriptorType::eSampler, 1000 },
-                { vk::DescriptorType::eCombinedImageSampler, 1000 },
-                { vk::DescriptorType::eSampledImage, 1000 },
-                { vk::DescriptorType::eStorageImage, 1000 },
-                { vk::DescriptorType::eUniformTexelBuffer, 1000 },
-                { vk::DescriptorType::eStorageTexelBuffer, 1000 },
-                { vk::DescriptorType::eUniformBuffer, 1000 },
-                { vk::DescriptorType::eStorageBuffer, 1000 },
-                { vk::DescriptorType::eUniformBufferDynamic, 1000 },
-                { vk::DescriptorType::eStorageBufferDynamic, 1000 },
-                { vk::DescriptorType::eInputAttachment, 1000 },
-            };
-
-            vk::DescriptorPoolCreateInfo poolInfo{};
-            poolInfo.setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
-            poolInfo.setPoolSizes(poolSizes);
-            poolInfo.setMaxSets(1000);
-
-            for (auto& pool : m_descriptorPools)
-            {
-                pool = m_device.createDescriptorPool(poolInfo);
-            }
+            vk::CommandPoolCreateInfo poolInfo{};
+            poolInfo.setQueueFamilyIndex(queueFamilyIndices.Transfer);
+            poolInfo.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient);
+
+            m_transferCommandPool = m_device.createCommandPool(poolInfo);
+        }
+
+        m_descriptorAllocator = CreateOwned<VulkanDescriptorAllocator>(m_device);
+        for (auto& allocator : m_frameDescriptorAllocators)
+        {
+            allocator = CreateOwned<VulkanDescriptorAllocator>(m_device);
         }
     }
 
@@ -70,13 +79,27 @@ namespace gfx
     {
         m_device.waitIdle();
 
-        for (const auto& pool : m_descriptorPools)
-            m_device.destroy(pool);
+        for (auto& allocator : m_frameDescriptorAllocators)
+            allocator = nullptr;
+        m_descriptorAllocator = nullptr;
 
+        m_device.destroy(m_transferCommandPool);
         m_device.destroy(m_commandPool);
         m_device.destroy();
     }
 
+    void VulkanDevice::Submit(vk::Queue queue, const vk::SubmitInfo& submitInfo, vk::Fence fence)
+    {
+        std::lock_guard lock(m_queueMutex);
+        queue.submit(submitInfo, fence);
+    }
+
+    void VulkanDevice::Present(const vk::PresentInfoKHR& presentInfo)
+    {
+        std::lock_guard lock(m_queueMutex);
+        void(m_graphicsQueue.presentKHR(presentInfo));
+    }
+
     void VulkanDevice::WaitForFence(vk::Fence fence)
     {
         void(m_device.waitForFences(fence, true, UINT64_MAX));
@@ -97,10 +120,14 @@ namespace gfx
         return m_device.acquireNextImageKHR(swapchain, UINT64_MAX, semaphore).value;
     }
 
-    auto VulkanDevice::GetCommandBuffer(bool begin) -> vk::CommandBuffer
+    auto VulkanDevice::GetCommandBuffer(bool begin) -> vk::CommandBuffer { return AllocateCommandBuffer(m_commandPool, begin); }
+
+    auto VulkanDevice::GetTransferCommandBuffer(bool begin) -> vk::CommandBuffer { return AllocateCommandBuffer(m_transferCommandPool, begin); }
+
+    auto VulkanDevice::AllocateCommandBuffer(vk::CommandPool commandPool, bool begin) -> vk::CommandBuffer
     {
         vk::CommandBufferAllocateInfo allocInfo{};
-        allocInfo.setCommandPool(m_commandPool);
+        allocInfo.setCommandPool(commandPool);
         allocInfo.setCommandBufferCount(1);
         allocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
 
@@ -130,7 +157,7 @@ namespace gfx
         vk::FenceCreateInfo fenceInfo{};
         auto fence = m_device.createFence(fenceInfo);
 
-        queue.submit(submitInfo, fence);
+        Submit(queue, submitInfo, fence);
 
         void(m_device.waitForFences(fence, true, UINT64_MAX));
 
@@ -139,18 +166,48 @@ namespace gfx
     }
 
     auto VulkanDevice::AllocateDescriptorSet(const uint32_t frameIndex,
-                                             vk::DescriptorSetLayout setLayout) -> vk::DescriptorSet
+                                             const VulkanDescriptorSetLayout& setLayout) -> vk::DescriptorSet
+    {
+        return m_frameDescriptorAllocators[frameIndex]->Allocate(setLayout);
+    }
+
+    void VulkanDevice::ResetDescriptorPool(const uint32_t frameIndex)
+    {
+        m_frameDescriptorAllocators[frameIndex]->Reset();
+
+        std::lock_guard lock(m_descriptorSetCacheMutex);
+        m_descriptorSetCaches[frameIndex].clear();
+    }
+
+    auto VulkanDevice::FindDescriptorSet(const uint32_t frameIndex, const std::vector<uint64_t>& key) const -> vk::DescriptorSet
     {
-        vk::DescriptorSetAllocateInfo allocInfo{};
-        allocInfo.setDescriptorPool(m_descriptorPools[frameIndex]);
-        allocInfo.setDescriptorSetCount(1);
-        allocInfo.setSetLayouts(setLayout);
+        const auto hash = HashBytes(key.data(), key.size() * sizeof(uint64_t));
+
+        std::lock_guard lock(m_descriptorSetCacheMutex);
+        const auto& cache = m_descriptorSetCaches[frameIndex];
+        const auto it = cache.find(hash);
+        if (it == cache.end()) return {};
 
-        return m_device.allocateDescriptorSets(allocInfo)[0];
+        for (const auto& cached : it->second)
+        {
+            if (cached.Key == key) return cached.Set;
+        }
+        return {};
     }
 
-    void VulkanDevice::ResetDescriptorPool(const uint32_t frameIndex) const
+    auto VulkanDevice::CacheDescriptorSet(const uint32_t frameIndex, std::vector<uint64_t> key, vk::DescriptorSet set) -> vk::DescriptorSet
     {
-        m_device.resetDescriptorPool(m_descriptorPools[frameIndex]);
+        const auto hash = HashBytes(key.data(), key.size() * sizeof(uint64_t));
+
+        // Lookup and insert are one step, so every thread missing on the same key ends up with the same set
+        std::lock_guard lock(m_descriptorSetCacheMutex);
+        auto& bucket = m_descriptorSetCaches[frameIndex][hash];
+        for (const auto& cached : bucket)
+        {
+            if (cached.Key == key) return cached.Set;
+        }
+
+        bucket.push_back({ std::move(key), set });
+        return set;
     }
 }
@@ -1,10 +1,18 @@
 #pragma once
 
 #include "VulkanPhysicalDevice.h"
+#include "VulkanDescriptorAllocator.h"
 #include "GFX/Config.h"
+#include "GFX/Core/Base.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace gfx
 {
     class VulkanDevice
@@ -15,6 +23,13 @@ namespace gfx
 
         auto GetHandle() -> vk::Device { return m_device; }
         auto GetGraphicsQueue() -> vk::Queue { return m_graphicsQueue; }
+        // The same queue as GetGraphicsQueue() if the device has no separate transfer family
+        auto GetTransferQueue() -> vk::Queue { return m_transferQueue; }
+
+        // Queues have to be externally synchronised and uploads are submitted from any thread, while frames are submitted
+        // from the render thread. Every submission and present goes through these so they never overlap.
+        void Submit(vk::Queue queue, const vk::SubmitInfo& submitInfo, vk::Fence fence = {});
+        void Present(const vk::PresentInfoKHR& presentInfo);
 
         void WaitForFence(vk::Fence fence);
         void WaitIdle();
@@ -23,20 +38,57 @@ namespace gfx
 
         auto AcquireNextImage(vk::SwapchainKHR swapchain, vk::Semaphore semaphore) -> uint32_t;
 
+        // The command pools below are shared by every thread. Hold the lock while allocating, recording or freeing their
+        // command buffers, command buffers recorded for a frame use their own pools instead.
+        auto LockCommandPools() -> std::unique_lock<std::mutex> { return std::unique_lock(m_commandPoolMutex); }
+
+        auto GetCommandPool() -> vk::CommandPool { return m_commandPool; }
         auto GetCommandBuffer(bool begin) -> vk::CommandBuffer;
+        auto GetTransferCommandPool() -> vk::CommandPool { return m_transferCommandPool; }
+        auto GetTransferCommandBuffer(bool begin) -> vk::CommandBuffer;
         void FlushCommandBuffer(vk::CommandBuffer cmdBuffer);
         void FlushCommandBuffer(vk::CommandBuffer cmdBuffer, vk::Queue queue);
 
-        auto AllocateDescriptorSet(uint32_t frameIndex, vk::DescriptorSetLayout setLayout) -> vk::DescriptorSet;
-        void ResetDescriptorPool(uint32_t frameIndex) const;
+        // Allocator of descriptor sets which outlive a frame
+        auto GetDescriptorAllocator() -> VulkanDescriptorAllocator& { return *m_descriptorAllocator; }
+
+        // Sets allocated for a frame are only valid until the frame's descriptor pools are reset
+        auto AllocateDescriptorSet(uint32_t frameIndex, const VulkanDescriptorSetLayout& setLayout) -> vk::DescriptorSet;
+        // Resetting a frame's pools also clears its descriptor set cache
+        void ResetDescriptorPool(uint32_t frameIndex);
+
+        // Sets allocated from a frame's pool by their layout and written descriptors, lets identical resource sets share one
+        // set until the frame's pool is reset. `key` holds every field the set was written from, hits compare it in full.
+        // Returns a null handle on a miss. Thread-safe, resource sets are updated from the recording threads.
+        auto FindDescriptorSet(uint32_t frameIndex, const std::vector<uint64_t>& key) const -> vk::DescriptorSet;
+        // `set` has to be fully written. Returns the set to use, which is an earlier one if another thread cached the same
+        // key first. The losing set stays unused until the frame's pool is reset.
+        auto CacheDescriptorSet(uint32_t frameIndex, std::vector<uint64_t> key, vk::DescriptorSet set) -> vk::DescriptorSet;
+
+    private:
+        struct CachedDescriptorSet
+        {
+            std::vector<uint64_t> Key;
+            vk::DescriptorSet Set;
+        };
+
+    private:
+        auto AllocateCommandBuffer(vk::CommandPool commandPool, bool begin) -> vk::CommandBuffer;
 
     private:
         VulkanPhysicalDevice& m_physicalDevice;
         vk::Device m_device;
 
         vk::Queue m_graphicsQueue;
+        vk::Queue m_transferQueue;
+        std::mutex m_queueMutex;
 
+        std::mutex m_commandPoolMutex;
         vk::CommandPool m_commandPool;
-        std::array<vk::DescriptorPool, gfx::Config::FramesInFlight> m_descriptorPools;
+        vk::CommandPool m_transferCommandPool;
+        OwnedPtr<VulkanDescriptorAllocator> m_descriptorAllocator;
+        std::array<OwnedPtr<VulkanDescriptorAllocator>, gfx::Config::FramesInFlight> m_frameDescriptorAllocators;
+        mutable std::mutex m_descriptorSetCacheMutex;
+        std::array<std::unordered_map<uint64_t, std::vector<CachedDescriptorSet>>, gfx::Config::FramesInFlight> m_descriptorSetCaches;
     };
 }
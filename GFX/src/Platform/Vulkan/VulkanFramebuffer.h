@@ -20,6 +20,7 @@ namespace gfx
         auto GetColorTexture(uint32_t index) const -> Texture* override { return m_attachmentTextures[index].get(); }
         auto GetDepthTexture() const -> Texture* override { return m_depthAttachentTexture.get(); }
 
+        auto GetDesc() const -> const FramebufferDesc& { return m_desc; }
         auto GetBeginInfo() const -> vk::RenderPassBeginInfo;
 
         auto GetRenderPass() const -> vk::RenderPass { return m_renderPass; }
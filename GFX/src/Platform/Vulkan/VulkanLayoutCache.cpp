@@ -0,0 +1,149 @@
+#include "VulkanLayoutCache.h"
+
+#include "Utility/Hash.h"
+#include "VulkanBackend.h"
+
+#include <algorithm>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        template <typename Map, typename Key>
+        auto LockOrErase(Map& map, const Key& key) -> decltype(map.begin()->second.lock())
+        {
+            const auto it = map.find(key);
+            if (it == map.end()) return nullptr;
+
+            auto value = it->second.lock();
+            if (value == nullptr) map.erase(it);
+            return value;
+        }
+    }
+
+    VulkanDescriptorSetLayout::~VulkanDescriptorSetLayout()
+    {
+        auto vkDevice = VulkanBackend::Get()->GetDevice().GetHandle();
+        for (const auto& [key, updateTemplate] : m_updateTemplates)
+        {
+            vkDevice.destroy(updateTemplate);
+        }
+        vkDevice.destroy(Handle);
+    }
+
+    auto VulkanDescriptorSetLayout::GetUpdateTemplate(const std::vector<vk::DescriptorUpdateTemplateEntry>& entries) const -> vk::DescriptorUpdateTemplate
+    {
+        const auto key = HashBytes(entries.data(), entries.size() * sizeof(vk::DescriptorUpdateTemplateEntry));
+
+        std::lock_guard lock(m_templatesMutex);
+        auto& updateTemplate = m_updateTemplates[key];
+        if (!updateTemplate)
+        {
+            vk::DescriptorUpdateTemplateCreateInfo templateInfo{};
+            templateInfo.setTemplateType(vk::DescriptorUpdateTemplateType::eDescriptorSet);
+            templateInfo.setDescriptorSetLayout(Handle);
+            templateInfo.setDescriptorUpdateEntries(entries);
+
+            auto vkDevice = VulkanBackend::Get()->GetDevice().GetHandle();
+            updateTemplate = vkDevice.createDescriptorUpdateTemplate(templateInfo);
+        }
+        return updateTemplate;
+    }
+
+    VulkanPipelineLayout::~VulkanPipelineLayout()
+    {
+        auto vkDevice = VulkanBackend::Get()->GetDevice().GetHandle();
+        vkDevice.destroy(Handle);
+    }
+
+    auto VulkanPipelineLayout::GetCompatibleSetCount(const VulkanPipelineLayout& other) const -> uint32_t
+    {
+        // Layouts are only compatible for any set if their push constant ranges match
+        if (PushConstantRanges != other.PushConstantRanges) return 0;
+
+        uint32_t count = 0;
+        while (count < SetLayouts.size() && count < other.SetLayouts.size() && SetLayouts[count] == other.SetLayouts[count])
+            count++;
+        return count;
+    }
+
+    bool VulkanLayoutCache::SetLayoutKey::operator==(const SetLayoutKey& other) const
+    {
+        // Only the fields GetSetLayout() hashes, bindings never have immutable samplers
+        return std::equal(Bindings.begin(),
+                          Bindings.end(),
+                          other.Bindings.begin(),
+                          other.Bindings.end(),
+                          [](const vk::DescriptorSetLayoutBinding& lhs, const vk::DescriptorSetLayoutBinding& rhs)
+                          {
+                              return lhs.binding == rhs.binding && lhs.descriptorType == rhs.descriptorType && lhs.descriptorCount == rhs.descriptorCount &&
+                                     lhs.stageFlags == rhs.stageFlags;
+                          });
+    }
+
+    auto VulkanLayoutCache::GetSetLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings) -> SharedPtr<const VulkanDescriptorSetLayout>
+    {
+        std::sort(bindings.begin(), bindings.end(), [](const auto& lhs, const auto& rhs) { return lhs.binding < rhs.binding; });
+
+        SetLayoutKey key{ bindings, HashValue(bindings.size()) };
+        for (const auto& binding : bindings)
+        {
+            key.Hash = HashValue(binding.binding, key.Hash);
+            key.Hash = HashValue(binding.descriptorType, key.Hash);
+            key.Hash = HashValue(binding.descriptorCount, key.Hash);
+            key.Hash = HashValue(VkShaderStageFlags(binding.stageFlags), key.Hash);
+        }
+
+        std::lock_guard lock(m_mutex);
+        if (auto layout = Utils::LockOrErase(m_setLayouts, key)) return layout;
+
+        vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.setBindings(bindings);
+
+        auto layout = CreateShared<VulkanDescriptorSetLayout>();
+        layout->Handle = VulkanBackend::Get()->GetDevice().GetHandle().createDescriptorSetLayout(layoutInfo);
+        for (const auto& binding : bindings)
+        {
+            auto it = std::find_if(layout->PoolSizes.begin(), layout->PoolSizes.end(), [&](const auto& size) { return size.type == binding.descriptorType; });
+            if (it == layout->PoolSizes.end()) it = layout->PoolSizes.insert(it, vk::DescriptorPoolSize(binding.descriptorType, 0));
+            it->descriptorCount += binding.descriptorCount;
+        }
+
+        m_setLayouts[std::move(key)] = layout;
+        return layout;
+    }
+
+    auto VulkanLayoutCache::GetPipelineLayout(const std::vector<SharedPtr<const VulkanDescriptorSetLayout>>& setLayouts,
+                                              const std::vector<vk::PushConstantRange>& pushConstantRanges) -> SharedPtr<const VulkanPipelineLayout>
+    {
+        PipelineLayoutKey key{ {}, pushConstantRanges, HashValue(pushConstantRanges.size()) };
+        for (const auto& range : pushConstantRanges)
+        {
+            key.Hash = HashValue(VkShaderStageFlags(range.stageFlags), key.Hash);
+            key.Hash = HashValue(range.offset, key.Hash);
+            key.Hash = HashValue(range.size, key.Hash);
+        }
+
+        key.Hash = HashValue(setLayouts.size(), key.Hash);
+        for (const auto& setLayout : setLayouts)
+        {
+            key.SetLayouts.push_back(setLayout->Handle);
+            key.Hash = HashValue(VkDescriptorSetLayout(setLayout->Handle), key.Hash);
+        }
+
+        std::lock_guard lock(m_mutex);
+        if (auto layout = Utils::LockOrErase(m_pipelineLayouts, key)) return layout;
+
+        vk::PipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.setSetLayouts(key.SetLayouts);
+        layoutInfo.setPushConstantRanges(pushConstantRanges);
+
+        auto layout = CreateShared<VulkanPipelineLayout>();
+        layout->Handle = VulkanBackend::Get()->GetDevice().GetHandle().createPipelineLayout(layoutInfo);
+        layout->SetLayouts = setLayouts;
+        layout->PushConstantRanges = pushConstantRanges;
+
+        m_pipelineLayouts[std::move(key)] = layout;
+        return layout;
+    }
+}
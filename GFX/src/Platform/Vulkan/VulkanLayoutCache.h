@@ -0,0 +1,86 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx
+{
+    struct VulkanDescriptorSetLayout
+    {
+        vk::DescriptorSetLayout Handle;
+        std::vector<vk::DescriptorPoolSize> PoolSizes;  // Descriptors of each type one set needs
+
+        ~VulkanDescriptorSetLayout();
+
+        // Update templates are created on first use for each distinct set of entries and live as long as the layout
+        auto GetUpdateTemplate(const std::vector<vk::DescriptorUpdateTemplateEntry>& entries) const -> vk::DescriptorUpdateTemplate;
+
+    private:
+        mutable std::mutex m_templatesMutex;
+        mutable std::unordered_map<uint64_t, vk::DescriptorUpdateTemplate> m_updateTemplates;
+    };
+
+    struct VulkanPipelineLayout
+    {
+        vk::PipelineLayout Handle;
+        // Kept alive so a handle is never reused for different bindings while a layout still refers to it
+        std::vector<SharedPtr<const VulkanDescriptorSetLayout>> SetLayouts;
+        std::vector<vk::PushConstantRange> PushConstantRanges;
+
+        ~VulkanPipelineLayout();
+
+        // Sets bound through `other` stay bound after switching to this layout up to, but not including, the returned set
+        auto GetCompatibleSetCount(const VulkanPipelineLayout& other) const -> uint32_t;
+    };
+
+    // Interns descriptor set layouts by their bindings and pipeline layouts by their set layouts and push constant ranges.
+    // Shaders with the same bindings therefore share layouts, so their resource sets are interchangeable and switching
+    // between their pipelines keeps the bound sets. Only weak references are held, layouts die with their last user.
+    class VulkanLayoutCache
+    {
+    public:
+        auto GetSetLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings) -> SharedPtr<const VulkanDescriptorSetLayout>;
+        auto GetPipelineLayout(const std::vector<SharedPtr<const VulkanDescriptorSetLayout>>& setLayouts,
+                               const std::vector<vk::PushConstantRange>& pushConstantRanges) -> SharedPtr<const VulkanPipelineLayout>;
+
+    private:
+        // Keys hold everything a layout is created from and are compared in full, the hash only picks the bucket
+        struct SetLayoutKey
+        {
+            std::vector<vk::DescriptorSetLayoutBinding> Bindings;  // Sorted by binding
+            uint64_t Hash = 0;
+
+            bool operator==(const SetLayoutKey& other) const;
+        };
+
+        struct PipelineLayoutKey
+        {
+            std::vector<vk::DescriptorSetLayout> SetLayouts;  // Interned, so their handles identify their bindings
+            std::vector<vk::PushConstantRange> PushConstantRanges;
+            uint64_t Hash = 0;
+
+            bool operator==(const PipelineLayoutKey& other) const = default;
+        };
+
+        struct KeyHash
+        {
+            template <typename T>
+            auto operator()(const T& key) const -> size_t
+            {
+                return size_t(key.Hash);
+            }
+        };
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_map<SetLayoutKey, std::weak_ptr<const VulkanDescriptorSetLayout>, KeyHash> m_setLayouts;
+        std::unordered_map<PipelineLayoutKey, std::weak_ptr<const VulkanPipelineLayout>, KeyHash> m_pipelineLayouts;
+    };
+}
@@ -32,6 +32,18 @@ namespace gfx
         m_properties = m_physicalDevice.getProperties();
         GFX_INFO("Physical Device: {}", m_properties.deviceName);
 
+        const auto properties = m_physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+        m_properties12 = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+        m_properties12.setPNext(nullptr);
+
+        const auto features =
+            m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features, vk::PhysicalDeviceVulkan12Features>();
+        m_features = features.get<vk::PhysicalDeviceFeatures2>().features;
+        m_features11 = features.get<vk::PhysicalDeviceVulkan11Features>();
+        m_features11.setPNext(nullptr);
+        m_features12 = features.get<vk::PhysicalDeviceVulkan12Features>();
+        m_features12.setPNext(nullptr);
+
         m_depthFormat = FindDepthFormat();
         GFX_INFO("  Depth Format: {}", vk::to_string(m_depthFormat));
 
@@ -25,6 +25,10 @@ namespace gfx
         auto GetHandle() const -> vk::PhysicalDevice { return m_physicalDevice; }
 
         auto GetProperties() const -> const vk::PhysicalDeviceProperties& { return m_properties; }
+        auto GetProperties12() const -> const vk::PhysicalDeviceVulkan12Properties& { return m_properties12; }
+        auto GetFeatures() const -> const vk::PhysicalDeviceFeatures& { return m_features; }
+        auto GetFeatures11() const -> const vk::PhysicalDeviceVulkan11Features& { return m_features11; }
+        auto GetFeatures12() const -> const vk::PhysicalDeviceVulkan12Features& { return m_features12; }
 
         auto GetDepthFormat() const -> vk::Format { return m_depthFormat; }
         auto GetQueueFamilyIndices() const -> const QueueFamilyIndices& { return m_queueFamilyIndices; }
@@ -39,6 +43,10 @@ namespace gfx
         vk::PhysicalDevice m_physicalDevice;
 
         vk::PhysicalDeviceProperties m_properties;
+        vk::PhysicalDeviceVulkan12Properties m_properties12;
+        vk::PhysicalDeviceFeatures m_features;
+        vk::PhysicalDeviceVulkan11Features m_features11;
+        vk::PhysicalDeviceVulkan12Features m_features12;
 
         vk::Format m_depthFormat;
         QueueFamilyIndices m_queueFamilyIndices;
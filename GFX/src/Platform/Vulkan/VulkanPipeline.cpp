@@ -1,10 +1,13 @@
 ﻿#include "VulkanPipeline.h"
 
+#include "GFX/Debug.h"
+
 #include "VulkanBackend.h"
 #include "VulkanDevice.h"
 #include "VulkanFramebuffer.h"
 #include "VulkanShader.h"
 
+#include <chrono>
 #include <vector>
 
 namespace gfx
@@ -52,57 +55,75 @@ namespace gfx
     VulkanPipeline::VulkanPipeline(const PipelineDesc& desc)
         : m_desc(desc)
     {
-        auto backend = VulkanBackend::Get();
-        auto vkDevice = backend->GetDevice().GetHandle();
+        m_state = VulkanBackend::Get()->GetPipelineRegistry().GetOrCreate(desc);
+        m_ready = true;
+    }
 
-        auto* vkFramebuffer = static_cast<VulkanFramebuffer*>(desc.Framebuffer);
-        auto* vkShader = static_cast<VulkanShader*>(desc.Shader);
+    VulkanPipeline::VulkanPipeline(const PipelineDesc& desc, VulkanPipeline* placeholder, std::function<void()> onReady)
+        : m_desc(desc),
+          m_placeholder(placeholder)
+    {
+        auto compile = [this, onReady = std::move(onReady)]()
+        {
+            m_state = VulkanBackend::Get()->GetPipelineRegistry().GetOrCreate(m_desc);
+            m_ready.store(true, std::memory_order_release);
 
-        const auto& pushConstantRanges = vkShader->GetPushConstantRanges();
+            if (onReady) onReady();
+        };
+        m_compile = std::async(std::launch::async, std::move(compile));
+    }
 
-        std::vector<vk::PushConstantRange> vkPushConstantRanges(pushConstantRanges.size());
-        for (int i = 0; i < pushConstantRanges.size(); i++)
-        {
-            const auto& pushConstantRange = pushConstantRanges[i];
-            auto& vkPushConstantRange = vkPushConstantRanges[i];
+    VulkanPipeline::~VulkanPipeline()
+    {
+        // The worker still uses this pipeline's description
+        if (m_compile.valid()) m_compile.wait();
+    }
 
-            vkPushConstantRange.stageFlags = pushConstantRange.ShaderStage;
-            vkPushConstantRange.offset = (uint32_t)pushConstantRange.Offset;
-            vkPushConstantRange.size = (uint32_t)pushConstantRange.Size;
-        }
+    auto VulkanPipeline::Resolve() -> VulkanPipeline*
+    {
+        if (IsReady()) return this;
+        if (m_placeholder != nullptr) return m_placeholder->Resolve();
+
+        m_compile.wait();
+        return this;
+    }
 
-        auto descriptorSetLayouts = vkShader->GetDescriptorSetLayouts();
+    auto VulkanPipeline::CreateState(const PipelineDesc& desc) -> SharedPtr<VulkanPipelineState>
+    {
+        auto backend = VulkanBackend::Get();
+        auto vkDevice = backend->GetDevice().GetHandle();
 
-        vk::PipelineLayoutCreateInfo layoutInfo{};
-        layoutInfo.setSetLayouts(descriptorSetLayouts);
-        layoutInfo.setPushConstantRanges(vkPushConstantRanges);
+        auto* vkFramebuffer = static_cast<VulkanFramebuffer*>(desc.Framebuffer);
+        auto* vkShader = static_cast<VulkanShader*>(desc.Shader->GetVariant(desc.Keywords));
+        GFX_ASSERT(!vkShader->IsCompute(), "Compute shaders need a ComputePipeline!");
 
-        m_layout = vkDevice.createPipelineLayout(layoutInfo);
+        auto state = CreateShared<VulkanPipelineState>();
+        state->Layout = vkShader->GetPipelineLayout();
 
         vk::GraphicsPipelineCreateInfo pipelineInfo{};
-        pipelineInfo.setLayout(m_layout);
+        pipelineInfo.setLayout(state->Layout->Handle);
         pipelineInfo.setRenderPass(vkFramebuffer->GetRenderPass());
 
         vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{};
-        inputAssemblyState.setTopology(Utils::ToVulkanTopology(m_desc.Topology));
+        inputAssemblyState.setTopology(Utils::ToVulkanTopology(desc.Topology));
 
         vk::PipelineRasterizationStateCreateInfo rasterizationState{};
-        rasterizationState.setPolygonMode(m_desc.Wireframe ? vk::PolygonMode::eLine : vk::PolygonMode::eFill);
-        rasterizationState.setCullMode(Utils::ToVulkanCullMode(m_desc.CullMode));
+        rasterizationState.setPolygonMode(desc.Wireframe ? vk::PolygonMode::eLine : vk::PolygonMode::eFill);
+        rasterizationState.setCullMode(Utils::ToVulkanCullMode(desc.CullMode));
         rasterizationState.setFrontFace(vk::FrontFace::eCounterClockwise);
         rasterizationState.setDepthClampEnable(false);
         rasterizationState.setRasterizerDiscardEnable(false);
         rasterizationState.setDepthBiasClamp(false);
-        rasterizationState.setDepthBiasEnable(m_desc.DepthBias);
-        rasterizationState.setDepthBiasConstantFactor(m_desc.DepthBiasConstantFactor);
-        rasterizationState.setDepthBiasSlopeFactor(m_desc.DepthBiasSlopeFactor);
-        rasterizationState.setLineWidth(m_desc.LineWidth); // Dynamic
+        rasterizationState.setDepthBiasEnable(desc.DepthBias);
+        rasterizationState.setDepthBiasConstantFactor(desc.DepthBiasConstantFactor);
+        rasterizationState.setDepthBiasSlopeFactor(desc.DepthBiasSlopeFactor);
+        rasterizationState.setLineWidth(desc.LineWidth); // Dynamic
 
         // Color blend state describes how blend factors are calculated (if used)
         // We need one blend attachment state per color attachment (even if blending is not used)
         auto colorAttachmentCount = desc.Framebuffer->IsSwapChainTarget() ? 1 : desc.Framebuffer->GetColorAttachmentCount();
         std::vector<vk::PipelineColorBlendAttachmentState> blendAttachmentStates(colorAttachmentCount);
-        if (m_desc.Framebuffer->IsSwapChainTarget())
+        if (desc.Framebuffer->IsSwapChainTarget())
         {
             blendAttachmentStates[0].setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB |
                 vk::ColorComponentFlagBits::eA);
@@ -141,15 +162,15 @@ namespace gfx
         std::vector<vk::DynamicState> dynamicStateEnables;
         dynamicStateEnables.push_back(vk::DynamicState::eViewport);
         dynamicStateEnables.push_back(vk::DynamicState::eScissor);
-        if (m_desc.Topology == PrimitiveTopology::eLines /*|| m_desc.Topology == PrimitiveTopology::eLineStrip*/ || m_desc.Wireframe)
+        if (desc.Topology == PrimitiveTopology::eLines /*|| desc.Topology == PrimitiveTopology::eLineStrip*/ || desc.Wireframe)
             dynamicStateEnables.push_back(vk::DynamicState::eLineWidth);
 
         vk::PipelineDynamicStateCreateInfo dynamicState{};
         dynamicState.setDynamicStates(dynamicStateEnables);
 
         vk::PipelineDepthStencilStateCreateInfo depthStencilState{};
-        depthStencilState.setDepthTestEnable(m_desc.DepthTest);
-        depthStencilState.setDepthWriteEnable(m_desc.DepthWrite);
+        depthStencilState.setDepthTestEnable(desc.DepthTest);
+        depthStencilState.setDepthWriteEnable(desc.DepthWrite);
         depthStencilState.setDepthCompareOp(vk::CompareOp::eLessOrEqual);
         depthStencilState.setDepthBoundsTestEnable(false);
         depthStencilState.back.failOp = vk::StencilOp::eKeep;
@@ -162,7 +183,7 @@ namespace gfx
         multisampleState.setRasterizationSamples(vk::SampleCountFlagBits::e1);
         multisampleState.setPSampleMask(nullptr);
 
-        auto& layout = m_desc.Layout;
+        auto& layout = desc.Layout;
 
         vk::VertexInputBindingDescription vertexInputBinding{};
         vertexInputBinding.binding = 0;
@@ -186,7 +207,24 @@ namespace gfx
         vertexInputState.setVertexBindingDescriptions(vertexInputBinding);
         vertexInputState.setVertexAttributeDescriptions(vertexAttributes);
 
-        const auto& shaderStages = vkShader->GetShaderStageCreateInfos();
+        // Keywords backed by specialization constants are enabled here, one SPIR-V module serves every combination
+        std::vector<vk::SpecializationMapEntry> specializationEntries;
+        std::vector<vk::Bool32> specializationData;
+        vkShader->GetSpecializationData(desc.Keywords, specializationEntries, specializationData);
+
+        vk::SpecializationInfo specializationInfo{};
+        specializationInfo.setMapEntries(specializationEntries);
+        specializationInfo.setData<vk::Bool32>(specializationData);
+
+        // Map entries for constants a stage does not declare are ignored, so every stage can share the same info
+        auto shaderStages = vkShader->GetShaderStageCreateInfos();
+        if (!specializationEntries.empty())
+        {
+            for (auto& shaderStage : shaderStages)
+            {
+                shaderStage.setPSpecializationInfo(&specializationInfo);
+            }
+        }
 
         pipelineInfo.setStages(shaderStages);
         pipelineInfo.setPVertexInputState(&vertexInputState);
@@ -198,15 +236,12 @@ namespace gfx
         pipelineInfo.setPDepthStencilState(&depthStencilState);
         pipelineInfo.setPDynamicState(&dynamicState);
 
-        m_pipeline = vkDevice.createGraphicsPipeline({}, pipelineInfo).value;
-    }
+        auto& pipelineCache = backend->GetPipelineCache();
 
-    VulkanPipeline::~VulkanPipeline()
-    {
-        auto* backend = VulkanBackend::Get();
-        auto vkDevice = backend->GetDevice().GetHandle();
+        const auto start = std::chrono::high_resolution_clock::now();
+        state->Pipeline = vkDevice.createGraphicsPipeline(pipelineCache.GetHandle(), pipelineInfo).value;
+        pipelineCache.RecordCreation(std::chrono::high_resolution_clock::now() - start);
 
-        vkDevice.destroy(m_layout);
-        vkDevice.destroy(m_pipeline);
+        return state;
     }
 }
@@ -1,25 +1,44 @@
 ﻿#pragma once
 
 #include "GFX/Resources/Pipeline.h"
+#include "VulkanPipelineRegistry.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+#include <functional>
+#include <future>
+
 namespace gfx
 {
     class VulkanPipeline : public Pipeline
     {
     public:
+        // Identical descriptions share their Vulkan objects through the backend's pipeline registry
         VulkanPipeline(const PipelineDesc& desc);
-        ~VulkanPipeline();
+        // Gets its state from the registry on a worker thread, see Pipeline::CreateAsync()
+        VulkanPipeline(const PipelineDesc& desc, VulkanPipeline* placeholder, std::function<void()> onReady);
+        ~VulkanPipeline() override;
 
-        auto GetPipelineHandle() -> vk::Pipeline { return m_pipeline; }
-        auto GetLayoutHandle() -> vk::PipelineLayout { return m_layout; }
+        bool IsReady() const override { return m_ready.load(std::memory_order_acquire); }
+        // The pipeline to bind in place of this one: itself once ready, otherwise its placeholder. Without a placeholder
+        // this waits for the compile to finish.
+        auto Resolve() -> VulkanPipeline*;
+
+        auto GetPipelineHandle() -> vk::Pipeline { return m_state->Pipeline; }
+        auto GetLayoutHandle() -> vk::PipelineLayout { return m_state->Layout->Handle; }
+        auto GetLayout() -> const VulkanPipelineLayout& { return *m_state->Layout; }
+
+        // Compiles the pipeline for `desc`, called by the registry on a miss
+        static auto CreateState(const PipelineDesc& desc) -> SharedPtr<VulkanPipelineState>;
 
-    private:
     private:
         PipelineDesc m_desc;
 
-        vk::PipelineLayout m_layout;
-        vk::Pipeline m_pipeline;
+        SharedPtr<const VulkanPipelineState> m_state;  // Only valid once ready
+
+        VulkanPipeline* m_placeholder = nullptr;
+        std::atomic<bool> m_ready = false;
+        std::future<void> m_compile;
     };
 }
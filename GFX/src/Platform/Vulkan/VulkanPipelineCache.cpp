@@ -0,0 +1,164 @@
+#include "VulkanPipelineCache.h"
+
+#include "GFX/Debug.h"
+
+#include "VulkanDevice.h"
+#include "VulkanPhysicalDevice.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        constexpr uint32_t PipelineCacheMagic = 0x43505847;  // "GXPC"
+        constexpr uint32_t PipelineCacheFileVersion = 1;
+
+        // Precedes the driver's cache data in the file
+        struct PipelineCacheFileHeader
+        {
+            uint32_t Magic;
+            uint32_t FileVersion;
+            uint32_t DriverVersion;
+            uint32_t DataSize;
+            uint8_t CacheUUID[VK_UUID_SIZE];
+        };
+
+        // Header every driver puts at the start of its cache data (VkPipelineCacheHeaderVersionOne)
+        struct PipelineCacheDataHeader
+        {
+            uint32_t HeaderSize;
+            uint32_t HeaderVersion;
+            uint32_t VendorID;
+            uint32_t DeviceID;
+            uint8_t CacheUUID[VK_UUID_SIZE];
+        };
+
+        auto GetPipelineCacheFilename(const vk::PhysicalDeviceProperties& properties) -> std::string
+        {
+            std::string uuid;
+            for (const auto byte : properties.pipelineCacheUUID)
+            {
+                uuid += fmt::format("{:02x}", byte);
+            }
+            return fmt::format("pipelines_{}_{:08x}.cache", uuid, properties.driverVersion);
+        }
+    }
+
+    VulkanPipelineCache::VulkanPipelineCache(VulkanDevice& device, VulkanPhysicalDevice& physicalDevice, const std::string& directory)
+        : m_device(device.GetHandle()), m_properties(physicalDevice.GetProperties())
+    {
+        if (!directory.empty())
+        {
+            m_path = std::filesystem::path(directory) / Utils::GetPipelineCacheFilename(m_properties);
+        }
+
+        const auto initialData = Load();
+        m_warm = !initialData.empty();
+
+        vk::PipelineCacheCreateInfo cacheInfo{};
+        cacheInfo.setInitialDataSize(initialData.size());
+        cacheInfo.setPInitialData(initialData.data());
+
+        m_cache = m_device.createPipelineCache(cacheInfo);
+        GFX_ASSERT(m_cache, "Failed to create pipeline cache!");
+
+        if (m_warm) GFX_INFO("Loaded pipeline cache '{}' ({} bytes).", m_path.string(), initialData.size());
+    }
+
+    VulkanPipelineCache::~VulkanPipelineCache()
+    {
+        const auto count = m_createdCount.load();
+        if (count > 0)
+        {
+            const auto milliseconds = double(m_creationTime.load()) / 1e6;
+            GFX_INFO("Created {} pipelines in {:.2f} ms with a {} pipeline cache.", count, milliseconds, m_warm ? "warm" : "cold");
+        }
+
+        Save();
+
+        m_device.destroy(m_cache);
+    }
+
+    void VulkanPipelineCache::RecordCreation(const std::chrono::nanoseconds duration)
+    {
+        m_createdCount++;
+        m_creationTime += duration.count();
+    }
+
+    void VulkanPipelineCache::Save() const
+    {
+        if (m_path.empty()) return;
+
+        const auto data = m_device.getPipelineCacheData(m_cache);
+        if (data.empty()) return;
+
+        Utils::PipelineCacheFileHeader header{};
+        header.Magic = Utils::PipelineCacheMagic;
+        header.FileVersion = Utils::PipelineCacheFileVersion;
+        header.DriverVersion = m_properties.driverVersion;
+        header.DataSize = uint32_t(data.size());
+        std::memcpy(header.CacheUUID, m_properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+
+        std::error_code error;
+        if (m_path.has_parent_path()) std::filesystem::create_directories(m_path.parent_path(), error);
+
+        // Write to a temporary file first, so an interrupted save never leaves a truncated cache behind
+        auto tempPath = m_path;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                GFX_WARN("Failed to write pipeline cache '{}'!", tempPath.string());
+                return;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+        }
+
+        std::filesystem::rename(tempPath, m_path, error);
+        if (error) GFX_WARN("Failed to write pipeline cache '{}': {}", m_path.string(), error.message());
+    }
+
+    auto VulkanPipelineCache::Load() const -> std::vector<uint8_t>
+    {
+        if (m_path.empty()) return {};
+
+        std::ifstream file(m_path, std::ios::binary);
+        if (!file) return {};
+
+        Utils::PipelineCacheFileHeader header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return {};
+
+        if (header.Magic != Utils::PipelineCacheMagic || header.FileVersion != Utils::PipelineCacheFileVersion ||
+            header.DriverVersion != m_properties.driverVersion || std::memcmp(header.CacheUUID, m_properties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0)
+        {
+            GFX_INFO("Discarding pipeline cache '{}', it was created by another device or driver.", m_path.string());
+            return {};
+        }
+
+        std::vector<uint8_t> data(header.DataSize);
+        if (!file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size())) || !IsCompatible(data))
+        {
+            GFX_WARN("Discarding invalid pipeline cache '{}'!", m_path.string());
+            return {};
+        }
+
+        return data;
+    }
+
+    bool VulkanPipelineCache::IsCompatible(const std::vector<uint8_t>& data) const
+    {
+        Utils::PipelineCacheDataHeader header{};
+        if (data.size() < sizeof(header)) return false;
+
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        return header.HeaderSize >= sizeof(header) && header.HeaderSize <= data.size() &&
+               header.HeaderVersion == uint32_t(vk::PipelineCacheHeaderVersion::eOne) && header.VendorID == m_properties.vendorID &&
+               header.DeviceID == m_properties.deviceID && std::memcmp(header.CacheUUID, m_properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+    class VulkanDevice;
+    class VulkanPhysicalDevice;
+
+    // Pipeline cache shared by every pipeline the backend creates. Its data is loaded from, and saved back to, a file
+    // named after the device's pipeline cache UUID and driver version, so a driver update starts from an empty cache.
+    class VulkanPipelineCache
+    {
+    public:
+        VulkanPipelineCache(VulkanDevice& device, VulkanPhysicalDevice& physicalDevice, const std::string& directory);
+        ~VulkanPipelineCache();
+
+        auto GetHandle() const -> vk::PipelineCache { return m_cache; }
+
+        // Accumulates pipeline creation times, reported when the cache is destroyed
+        void RecordCreation(std::chrono::nanoseconds duration);
+
+        void Save() const;
+
+    private:
+        auto Load() const -> std::vector<uint8_t>;
+        bool IsCompatible(const std::vector<uint8_t>& data) const;
+
+    private:
+        vk::Device m_device;
+        vk::PhysicalDeviceProperties m_properties;
+
+        std::filesystem::path m_path;
+        vk::PipelineCache m_cache;
+        bool m_warm = false;
+
+        std::atomic<uint32_t> m_createdCount = 0;
+        std::atomic<int64_t> m_creationTime = 0;
+    };
+}
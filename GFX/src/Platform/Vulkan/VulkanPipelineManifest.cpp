@@ -0,0 +1,333 @@
+#include "VulkanPipelineManifest.h"
+
+#include "GFX/Debug.h"
+#include "GFX/Resources/Shader.h"
+#include "Utility/BinaryStream.h"
+#include "Utility/Hash.h"
+#include "Utility/ParallelFor.h"
+#include "Utility/Timer.h"
+#include "VulkanFramebuffer.h"
+#include "VulkanShader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        constexpr uint32_t PipelineManifestMagic = 0x4D505847;  // "GXPM"
+        constexpr uint32_t PipelineManifestVersion = 1;
+
+        // Upper bounds for the counts read back from a manifest, far beyond anything written, to reject corrupt files early
+        constexpr uint32_t MaxManifestEntries = 1u << 16;
+        constexpr uint32_t MaxManifestEntryElements = 256;
+
+        struct PipelineManifestEntry
+        {
+            std::string ShaderPath;
+            PipelineDesc Desc{};  // Without shader and framebuffer, they are resolved on replay
+
+            // What a framebuffer needs to match for its render pass to be compatible, see VulkanPipelineRegistry::GetKey()
+            bool SwapChainTarget = false;
+            uint32_t Samples = 1;
+            std::vector<TextureFormat> Formats;
+        };
+
+        auto SerializeEntry(const std::string& shaderPath, const PipelineDesc& desc) -> std::vector<uint8_t>
+        {
+            BinaryWriter writer;
+            writer.Write(shaderPath);
+
+            // Sorted, so enabling the same keywords in another order makes the same entry
+            auto keywords = desc.Keywords;
+            std::sort(keywords.begin(), keywords.end());
+            keywords.erase(std::unique(keywords.begin(), keywords.end()), keywords.end());
+            writer.Write(uint32_t(keywords.size()));
+            for (const auto& keyword : keywords)
+            {
+                writer.Write(keyword);
+            }
+
+            writer.Write(desc.Layout.GetElementCount());
+            for (const auto& element : desc.Layout)
+            {
+                writer.Write(element.Name);
+                writer.Write(uint32_t(element.Type));
+                writer.Write(uint32_t(element.Normalized));
+            }
+
+            const auto* vkFramebuffer = static_cast<const VulkanFramebuffer*>(desc.Framebuffer);
+            writer.Write(uint32_t(vkFramebuffer->IsSwapChainTarget()));
+            writer.Write(vkFramebuffer->GetDesc().Samples);
+            writer.Write(uint32_t(vkFramebuffer->GetDesc().Attachments.size()));
+            for (const auto& attachment : vkFramebuffer->GetDesc().Attachments)
+            {
+                writer.Write(uint32_t(attachment.Format));
+            }
+
+            writer.Write(uint32_t(desc.Topology));
+            writer.Write(uint32_t(desc.CullMode));
+            writer.Write(uint32_t(desc.DepthTest));
+            writer.Write(uint32_t(desc.DepthWrite));
+            writer.Write(uint32_t(desc.Wireframe));
+            writer.Write(desc.LineWidth);
+            writer.Write(uint32_t(desc.DepthBias));
+            writer.Write(desc.DepthBiasConstantFactor);
+            writer.Write(desc.DepthBiasSlopeFactor);
+            return std::move(writer.GetData());
+        }
+
+        bool DeserializeEntry(const std::vector<uint8_t>& data, PipelineManifestEntry& entry)
+        {
+            BinaryReader reader(data);
+
+            // Every element starts with at least one uint32_t, a string length or a value
+            uint32_t count = 0;
+            if (!reader.Read(entry.ShaderPath) || !reader.ReadCount(count, sizeof(uint32_t)) || count > MaxManifestEntryElements) return false;
+            entry.Desc.Keywords.resize(count);
+            for (auto& keyword : entry.Desc.Keywords)
+            {
+                if (!reader.Read(keyword)) return false;
+            }
+
+            if (!reader.ReadCount(count, 3 * sizeof(uint32_t)) || count > MaxManifestEntryElements) return false;
+            std::vector<VertexElement> elements;
+            elements.reserve(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                std::string name;
+                uint32_t type = 0;
+                uint32_t normalized = 0;
+                if (!reader.Read(name) || !reader.Read(type) || !reader.Read(normalized)) return false;
+
+                elements.emplace_back(ShaderDataType(type), std::move(name), normalized != 0);
+            }
+            entry.Desc.Layout = VertexLayout(std::move(elements));
+
+            uint32_t swapChainTarget = 0;
+            if (!reader.Read(swapChainTarget) || !reader.Read(entry.Samples) || !reader.ReadCount(count, sizeof(uint32_t)) ||
+                count > MaxManifestEntryElements)
+                return false;
+            entry.SwapChainTarget = swapChainTarget != 0;
+            entry.Formats.resize(count);
+            for (auto& format : entry.Formats)
+            {
+                uint32_t value = 0;
+                if (!reader.Read(value)) return false;
+                format = TextureFormat(value);
+            }
+
+            uint32_t topology = 0;
+            uint32_t cullMode = 0;
+            uint32_t depthTest = 0;
+            uint32_t depthWrite = 0;
+            uint32_t wireframe = 0;
+            uint32_t depthBias = 0;
+            if (!reader.Read(topology) || !reader.Read(cullMode) || !reader.Read(depthTest) || !reader.Read(depthWrite) || !reader.Read(wireframe) ||
+                !reader.Read(entry.Desc.LineWidth) || !reader.Read(depthBias) || !reader.Read(entry.Desc.DepthBiasConstantFactor) ||
+                !reader.Read(entry.Desc.DepthBiasSlopeFactor))
+                return false;
+
+            entry.Desc.Topology = PrimitiveTopology(topology);
+            entry.Desc.CullMode = FaceCullMode(cullMode);
+            entry.Desc.DepthTest = depthTest != 0;
+            entry.Desc.DepthWrite = depthWrite != 0;
+            entry.Desc.Wireframe = wireframe != 0;
+            entry.Desc.DepthBias = depthBias != 0;
+            return reader.IsAtEnd();
+        }
+
+        bool LoadManifest(const std::filesystem::path& path, std::vector<std::vector<uint8_t>>& entries)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) return false;
+
+            const std::vector<uint8_t> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+            BinaryReader reader(data);
+
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint32_t count = 0;
+            if (!reader.Read(magic) || !reader.Read(version)) return false;
+            if (magic != PipelineManifestMagic || version != PipelineManifestVersion) return false;
+
+            // Every entry is at least its uint32_t size prefix
+            if (!reader.ReadCount(count, sizeof(uint32_t)) || count > MaxManifestEntries) return false;
+
+            entries.resize(count);
+            for (auto& entry : entries)
+            {
+                if (!reader.Read(entry)) return false;
+            }
+            return reader.IsAtEnd();
+        }
+
+        bool IsCompatible(const PipelineManifestEntry& entry, const VulkanFramebuffer& framebuffer)
+        {
+            if (entry.SwapChainTarget != framebuffer.IsSwapChainTarget() || entry.Samples != framebuffer.GetDesc().Samples) return false;
+
+            const auto& attachments = framebuffer.GetDesc().Attachments;
+            return std::equal(entry.Formats.begin(),
+                              entry.Formats.end(),
+                              attachments.begin(),
+                              attachments.end(),
+                              [](TextureFormat format, const FramebufferAttachmentDesc& attachment) { return format == attachment.Format; });
+        }
+    }
+
+    VulkanPipelineManifestRecorder::VulkanPipelineManifestRecorder(const std::string& path)
+        : m_path(path)
+    {
+        if (m_path.empty() || !std::filesystem::exists(m_path)) return;
+
+        if (!Utils::LoadManifest(m_path, m_entries))
+        {
+            GFX_WARN("Discarding pipeline manifest '{}', it is corrupt or was written by another version.", m_path.string());
+            m_entries.clear();
+            return;
+        }
+
+        for (const auto& entry : m_entries)
+        {
+            m_hashes.insert(HashBytes(entry.data(), entry.size()));
+        }
+    }
+
+    VulkanPipelineManifestRecorder::~VulkanPipelineManifestRecorder() { Save(); }
+
+    void VulkanPipelineManifestRecorder::Record(const PipelineDesc& desc)
+    {
+        if (m_path.empty()) return;
+
+        const auto& shaderPath = static_cast<const VulkanShader*>(desc.Shader)->GetSourcePath();
+        if (shaderPath.empty()) return;
+
+        auto data = Utils::SerializeEntry(shaderPath, desc);
+        const auto hash = HashBytes(data.data(), data.size());
+
+        std::lock_guard lock(m_mutex);
+        if (!m_hashes.insert(hash).second) return;
+
+        m_entries.push_back(std::move(data));
+        m_dirty = true;
+    }
+
+    void VulkanPipelineManifestRecorder::Save()
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_dirty) return;
+
+        BinaryWriter writer;
+        writer.Write(Utils::PipelineManifestMagic);
+        writer.Write(Utils::PipelineManifestVersion);
+        writer.Write(uint32_t(m_entries.size()));
+        for (const auto& entry : m_entries)
+        {
+            writer.Write(entry);
+        }
+        const auto& data = writer.GetData();
+
+        std::error_code error;
+        if (m_path.has_parent_path()) std::filesystem::create_directories(m_path.parent_path(), error);
+
+        // Write to a temporary file first, so an interrupted save never leaves a truncated manifest behind
+        auto tempPath = m_path;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                GFX_WARN("Failed to write pipeline manifest '{}'!", tempPath.string());
+                return;
+            }
+
+            file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+        }
+
+        std::filesystem::rename(tempPath, m_path, error);
+        if (error)
+        {
+            GFX_WARN("Failed to write pipeline manifest '{}': {}", m_path.string(), error.message());
+            return;
+        }
+
+        m_dirty = false;
+    }
+
+    VulkanPipelineManifest::VulkanPipelineManifest(const std::string& filename, const std::vector<Framebuffer*>& framebuffers)
+    {
+        Timer timer;
+
+        std::vector<std::vector<uint8_t>> data;
+        if (!Utils::LoadManifest(filename, data))
+        {
+            GFX_WARN("Failed to load pipeline manifest '{}'!", filename);
+            return;
+        }
+
+        std::vector<Utils::PipelineManifestEntry> entries;
+        entries.reserve(data.size());
+        for (const auto& entryData : data)
+        {
+            if (!Utils::DeserializeEntry(entryData, entries.emplace_back()))
+            {
+                GFX_WARN("Failed to load pipeline manifest '{}', it is corrupt!", filename);
+                return;
+            }
+        }
+
+        // Load every shader once, compiling them all across the worker threads
+        std::vector<std::string> shaderPaths;
+        std::vector<ShaderSources> shaderSources;
+        for (const auto& entry : entries)
+        {
+            if (std::find(shaderPaths.begin(), shaderPaths.end(), entry.ShaderPath) != shaderPaths.end()) continue;
+
+            ShaderSources sources;
+            if (Shader::LoadSources(entry.ShaderPath, sources))
+            {
+                shaderPaths.push_back(entry.ShaderPath);
+                shaderSources.push_back(std::move(sources));
+            }
+        }
+
+        m_shaders = Shader::CreateBatch(shaderSources);
+
+        std::unordered_map<std::string, Shader*> shaders;
+        for (size_t i = 0; i < shaderPaths.size(); i++)
+        {
+            shaders[shaderPaths[i]] = m_shaders[i].get();
+        }
+
+        std::vector<PipelineDesc> descs;
+        descs.reserve(entries.size());
+        for (auto& entry : entries)
+        {
+            const auto shaderIt = shaders.find(entry.ShaderPath);
+            const auto framebufferIt = std::find_if(framebuffers.begin(),
+                                                    framebuffers.end(),
+                                                    [&](Framebuffer* framebuffer)
+                                                    { return Utils::IsCompatible(entry, *static_cast<VulkanFramebuffer*>(framebuffer)); });
+            if (shaderIt == shaders.end() || framebufferIt == framebuffers.end())
+            {
+                m_stats.Skipped++;
+                continue;
+            }
+
+            entry.Desc.Shader = shaderIt->second;
+            entry.Desc.Framebuffer = *framebufferIt;
+            descs.push_back(std::move(entry.Desc));
+        }
+
+        // Creating a pipeline also compiles its shader variant on first use, pipelines and variants are thread safe to create
+        m_pipelines.resize(descs.size());
+        ParallelFor(uint32_t(descs.size()), [&](uint32_t i) { m_pipelines[i] = Pipeline::Create(descs[i]); });
+
+        m_stats.Pipelines = uint32_t(m_pipelines.size());
+        m_stats.Milliseconds = timer.ElapsedMillis();
+        GFX_INFO("Replayed {} pipelines from manifest '{}' in {:.2f} ms, skipped {}.", m_stats.Pipelines, filename, m_stats.Milliseconds, m_stats.Skipped);
+    }
+}
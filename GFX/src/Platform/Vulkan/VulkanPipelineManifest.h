@@ -0,0 +1,54 @@
+#pragma once
+
+#include "GFX/Resources/PipelineManifest.h"
+#include "GFX/Resources/Pipeline.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace gfx
+{
+    class Shader;
+
+    // Records the description of every pipeline the registry compiles, so a later session can replay them with
+    // PipelineManifest::Replay(). Entries already in the file are kept, the manifest grows across sessions.
+    class VulkanPipelineManifestRecorder
+    {
+    public:
+        // An empty `path` disables recording
+        VulkanPipelineManifestRecorder(const std::string& path);
+        ~VulkanPipelineManifestRecorder();
+
+        // Pipelines using shaders which were not loaded from a file cannot be replayed and are ignored
+        void Record(const PipelineDesc& desc);
+
+        void Save();
+
+    private:
+        std::filesystem::path m_path;
+
+        std::mutex m_mutex;
+        std::vector<std::vector<uint8_t>> m_entries;  // Serialized descriptions in the order they were first created
+        std::unordered_set<uint64_t> m_hashes;        // Hash of every entry's data
+        bool m_dirty = false;
+    };
+
+    class VulkanPipelineManifest : public PipelineManifest
+    {
+    public:
+        VulkanPipelineManifest(const std::string& filename, const std::vector<Framebuffer*>& framebuffers);
+        ~VulkanPipelineManifest() override = default;
+
+        auto GetStats() const -> const PipelineManifestStats& override { return m_stats; }
+
+    private:
+        std::vector<OwnedPtr<Shader>> m_shaders;
+        std::vector<OwnedPtr<Pipeline>> m_pipelines;
+
+        PipelineManifestStats m_stats{};
+    };
+}
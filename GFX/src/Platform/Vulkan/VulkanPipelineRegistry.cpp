@@ -0,0 +1,139 @@
+#include "VulkanPipelineRegistry.h"
+
+#include "GFX/Resources/Shader.h"
+#include "Utility/Hash.h"
+#include "VulkanBackend.h"
+#include "VulkanFramebuffer.h"
+#include "VulkanPipeline.h"
+#include "VulkanShader.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+    VulkanPipelineState::~VulkanPipelineState()
+    {
+        auto* backend = VulkanBackend::Get();
+        auto vkDevice = backend->GetDevice().GetHandle();
+
+        vkDevice.destroy(Pipeline);
+    }
+
+    auto VulkanPipelineRegistry::GetOrCreate(const PipelineDesc& desc) -> SharedPtr<const VulkanPipelineState>
+    {
+        auto key = GetKey(desc);
+
+        {
+            std::lock_guard lock(m_mutex);
+            const auto it = m_states.find(key);
+            if (it != m_states.end())
+            {
+                if (auto state = it->second.lock())
+                {
+                    m_hits++;
+                    return state;
+                }
+            }
+        }
+
+        // Create outside of the lock so pipelines can be compiled concurrently
+        SharedPtr<const VulkanPipelineState> state = VulkanPipeline::CreateState(desc);
+
+        std::lock_guard lock(m_mutex);
+        auto& entry = m_states[std::move(key)];
+        if (auto existing = entry.lock())
+        {
+            // Another thread created the same pipeline in the meantime, ours is released again
+            m_hits++;
+            return existing;
+        }
+
+        m_misses++;
+        entry = state;
+
+        VulkanBackend::Get()->GetPipelineManifestRecorder().Record(desc);
+
+        // Creating a pipeline takes far longer than walking the registry, so prune released states on every miss
+        std::erase_if(m_states, [](const auto& pair) { return pair.second.expired(); });
+
+        return state;
+    }
+
+    auto VulkanPipelineRegistry::GetStats() -> PipelineRegistryStats
+    {
+        std::lock_guard lock(m_mutex);
+
+        PipelineRegistryStats stats{};
+        stats.Hits = m_hits;
+        stats.Misses = m_misses;
+        stats.Pipelines = uint32_t(std::count_if(m_states.begin(), m_states.end(), [](const auto& pair) { return !pair.second.expired(); }));
+        return stats;
+    }
+
+    auto VulkanPipelineRegistry::GetKey(const PipelineDesc& desc) -> VulkanPipelineKey
+    {
+        VulkanPipelineKey key{};
+
+        // Keyword variants have their own shader and so their own code
+        const auto* vkShader = static_cast<const VulkanShader*>(desc.Shader->GetVariant(desc.Keywords));
+        for (const auto& [stage, code] : vkShader->GetStageCode())
+        {
+            key.Stages.push_back({ stage, code });
+        }
+        key.Hash = HashValue(vkShader->GetHash());
+
+        key.Keywords = desc.Keywords;
+        std::sort(key.Keywords.begin(), key.Keywords.end());
+        key.Keywords.erase(std::unique(key.Keywords.begin(), key.Keywords.end()), key.Keywords.end());
+        key.Hash = HashValue(key.Keywords.size(), key.Hash);
+        for (const auto& keyword : key.Keywords)
+        {
+            key.Hash = HashString(keyword, key.Hash);
+        }
+
+        key.Stride = desc.Layout.GetStride();
+        key.Hash = HashValue(key.Stride, key.Hash);
+        key.Hash = HashValue(desc.Layout.GetElementCount(), key.Hash);
+        for (const auto& element : desc.Layout)
+        {
+            key.Elements.emplace_back(element.Type, element.Offset);
+            key.Hash = HashValue(element.Type, key.Hash);
+            key.Hash = HashValue(element.Offset, key.Hash);
+        }
+
+        const auto* vkFramebuffer = static_cast<const VulkanFramebuffer*>(desc.Framebuffer);
+        key.SwapChainTarget = vkFramebuffer->IsSwapChainTarget();
+        key.Samples = vkFramebuffer->GetDesc().Samples;
+        key.Hash = HashValue(key.SwapChainTarget, key.Hash);
+        key.Hash = HashValue(key.Samples, key.Hash);
+        key.Hash = HashValue(vkFramebuffer->GetDesc().Attachments.size(), key.Hash);
+        for (const auto& attachment : vkFramebuffer->GetDesc().Attachments)
+        {
+            key.Formats.push_back(attachment.Format);
+            key.Hash = HashValue(attachment.Format, key.Hash);
+        }
+
+        key.Topology = desc.Topology;
+        key.CullMode = desc.CullMode;
+        key.DepthTest = desc.DepthTest;
+        key.DepthWrite = desc.DepthWrite;
+        key.Wireframe = desc.Wireframe;
+        key.LineWidth = desc.LineWidth;
+        key.DepthBias = desc.DepthBias;
+        key.DepthBiasConstantFactor = desc.DepthBiasConstantFactor;
+        key.DepthBiasSlopeFactor = desc.DepthBiasSlopeFactor;
+
+        key.Hash = HashValue(key.Topology, key.Hash);
+        key.Hash = HashValue(key.CullMode, key.Hash);
+        key.Hash = HashValue(key.DepthTest, key.Hash);
+        key.Hash = HashValue(key.DepthWrite, key.Hash);
+        key.Hash = HashValue(key.Wireframe, key.Hash);
+        key.Hash = HashValue(key.LineWidth, key.Hash);
+        key.Hash = HashValue(key.DepthBias, key.Hash);
+        key.Hash = HashValue(key.DepthBiasConstantFactor, key.Hash);
+        key.Hash = HashValue(key.DepthBiasSlopeFactor, key.Hash);
+        return key;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+#include "GFX/Resources/Pipeline.h"
+#include "GFX/Resources/Texture.h"
+#include "VulkanLayoutCache.h"
+#include "VulkanShaderCache.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gfx
+{
+    // The Vulkan objects behind a pipeline, shared by every VulkanPipeline created from an identical description
+    struct VulkanPipelineState
+    {
+        SharedPtr<const VulkanPipelineLayout> Layout;
+        vk::Pipeline Pipeline;
+
+        ~VulkanPipelineState();
+    };
+
+    // Everything a pipeline is created from. Looked up by its hash but compared in full, so two descriptions whose
+    // hashes collide never share a pipeline.
+    struct VulkanPipelineKey
+    {
+        struct StageCode
+        {
+            vk::ShaderStageFlagBits Stage{};
+            SharedPtr<const VulkanShaderCache::Entry> Code;
+
+            bool operator==(const StageCode& other) const { return Stage == other.Stage && (Code == other.Code || Code->Spirv == other.Code->Spirv); }
+        };
+
+        std::vector<StageCode> Stages;      // Of the keyword variant, ordered by stage
+        std::vector<std::string> Keywords;  // Sorted and without duplicates
+
+        uint32_t Stride = 0;
+        std::vector<std::pair<ShaderDataType, uint32_t>> Elements;  // Type and offset
+
+        // Pipelines can be used with any compatible render pass, which only depends on the attachment formats
+        bool SwapChainTarget = false;
+        uint32_t Samples = 1;
+        std::vector<TextureFormat> Formats;
+
+        PrimitiveTopology Topology{};
+        FaceCullMode CullMode{};
+        bool DepthTest = false;
+        bool DepthWrite = false;
+        bool Wireframe = false;
+        float LineWidth = 0.0f;
+        bool DepthBias = false;
+        float DepthBiasConstantFactor = 0.0f;
+        float DepthBiasSlopeFactor = 0.0f;
+
+        uint64_t Hash = 0;
+
+        bool operator==(const VulkanPipelineKey& other) const = default;
+    };
+
+    struct VulkanPipelineKeyHash
+    {
+        auto operator()(const VulkanPipelineKey& key) const -> size_t { return size_t(key.Hash); }
+    };
+
+    // Deduplicates graphics pipelines by their description. The registry only holds weak references, a state is
+    // destroyed together with the last pipeline using it.
+    class VulkanPipelineRegistry
+    {
+    public:
+        auto GetOrCreate(const PipelineDesc& desc) -> SharedPtr<const VulkanPipelineState>;
+
+        auto GetStats() -> PipelineRegistryStats;
+
+        static auto GetKey(const PipelineDesc& desc) -> VulkanPipelineKey;
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_map<VulkanPipelineKey, std::weak_ptr<const VulkanPipelineState>, VulkanPipelineKeyHash> m_states;
+
+        uint32_t m_hits = 0;
+        uint32_t m_misses = 0;
+    };
+}
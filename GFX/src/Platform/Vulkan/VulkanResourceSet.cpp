@@ -7,15 +7,18 @@
 #include "VulkanBuffer.h"
 #include "VulkanTexture.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace gfx
 {
     VulkanResourceSet::VulkanResourceSet(const uint32_t frameIndex, const uint32_t set, ResourceSetLayout* setLayout)
-        : m_set(set)
+        : m_set(set),
+          m_perFrame(true),
+          m_frameIndex(frameIndex)
     {
-        auto& device = VulkanBackend::Get()->GetDevice();
-
         auto* vkSetLayout = static_cast<VulkanResourceSetLayout*>(setLayout);
-        m_descriptorSet = device.AllocateDescriptorSet(frameIndex, vkSetLayout->GetHandle());
+        m_layout = vkSetLayout->GetLayout();
 
         m_bindings = vkSetLayout->GetBindings();
         for (auto& binding : m_bindings)
@@ -34,27 +37,11 @@ namespace gfx
         : m_set(set)
     {
         auto& device = VulkanBackend::Get()->GetDevice();
-        const auto vkDevice = device.GetHandle();
-
-        std::vector<vk::DescriptorPoolSize> poolSizes = {
-            { vk::DescriptorType::eUniformBuffer, 25 },
-            { vk::DescriptorType::eCombinedImageSampler, 25 },
-        };
-
-        vk::DescriptorPoolCreateInfo poolInfo{};
-        poolInfo.setPoolSizes(poolSizes);
-        poolInfo.setMaxSets(1);
-        m_descriptorPool = vkDevice.createDescriptorPool(poolInfo);
 
         auto* vkSetLayout = static_cast<VulkanResourceSetLayout*>(setLayout);
-        const auto setHandle = vkSetLayout->GetHandle();
-
-        vk::DescriptorSetAllocateInfo allocInfo{};
-        allocInfo.setDescriptorPool(m_descriptorPool);
-        allocInfo.setDescriptorSetCount(1);
-        allocInfo.setSetLayouts(setHandle);
+        m_layout = vkSetLayout->GetLayout();
 
-        m_descriptorSet = vkDevice.allocateDescriptorSets(allocInfo)[0];
+        m_descriptorSet = device.GetDescriptorAllocator().Allocate(*m_layout);
 
         m_bindings = vkSetLayout->GetBindings();
         for (auto& binding : m_bindings)
@@ -70,12 +57,10 @@ namespace gfx
 
     VulkanResourceSet::~VulkanResourceSet()
     {
-        if (m_descriptorPool)
+        if (!m_perFrame && m_descriptorSet)
         {
-            auto* backend = VulkanBackend::Get();
-            const auto vkDevice = backend->GetDevice().GetHandle();
-
-            vkDevice.destroy(m_descriptorPool);
+            auto& device = VulkanBackend::Get()->GetDevice();
+            device.GetDescriptorAllocator().Free(m_layout, m_descriptorSet);
         }
     }
 
@@ -102,6 +87,23 @@ namespace gfx
         resource.BufferInfo = vkBuffer->GetBufferInfo();
     }
 
+    void VulkanResourceSet::SetDynamicUniformBuffer(uint32_t binding, Buffer* buffer, size_t range)
+    {
+        // Check if this binding is valid for this set
+        if (m_validBindings.find(binding) == m_validBindings.end())
+            return;
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+
+        auto& resource = m_resources[binding];
+        resource.Binding = binding;
+        resource.Type = vk::DescriptorType::eUniformBufferDynamic;
+        resource.Buffer = nullptr;
+        resource.BufferInfo.setBuffer(vkBuffer->GetHandle());
+        resource.BufferInfo.setOffset(0);
+        resource.BufferInfo.setRange(range);
+    }
+
     void VulkanResourceSet::SetTextureSampler(uint32_t binding, uint32_t index, Texture* texture)
     {
         // Check if this binding is valid for this set
@@ -124,41 +126,118 @@ namespace gfx
         resource.ImageInfos[index] = vkTexture->GetImageInfo();
     }
 
+    void VulkanResourceSet::SetStorageBuffer(uint32_t binding, Buffer* buffer, size_t offset, size_t range)
+    {
+        // Check if this binding is valid for this set
+        if (m_validBindings.find(binding) == m_validBindings.end())
+            return;
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+
+        auto& resource = m_resources[binding];
+        resource.Binding = binding;
+        resource.Type = vk::DescriptorType::eStorageBuffer;
+        resource.Buffer = nullptr;
+        resource.BufferInfo.setBuffer(vkBuffer->GetHandle());
+        resource.BufferInfo.setOffset(offset);
+        resource.BufferInfo.setRange(range == 0 ? VK_WHOLE_SIZE : range);
+    }
+
+    void VulkanResourceSet::SetStorageImage(uint32_t binding, Texture* texture)
+    {
+        // Check if this binding is valid for this set
+        if (m_validBindings.find(binding) == m_validBindings.end())
+            return;
+
+        auto* vkTexture = static_cast<VulkanTexture*>(texture);
+
+        auto& resource = m_resources[binding];
+        resource.Binding = binding;
+        resource.Type = vk::DescriptorType::eStorageImage;
+        resource.Count = 1;
+        resource.Textures = { texture };
+        resource.ImageInfos = { vkTexture->GetImageInfo() };
+        resource.ImageInfos[0].setSampler(nullptr);
+    }
+
     void VulkanResourceSet::UpdateBindings()
     {
         auto& device = VulkanBackend::Get()->GetDevice();
         auto vkDevice = device.GetHandle();
 
-        // for (const auto& [binding, write] : m_descriptorWrites)
-        // {
-        //     if (!write.dstSet)
-        //         continue;
-        //     if (write.pImageInfo == nullptr && write.pBufferInfo == nullptr)
-        //         continue;
-        //
-        //     writes.push_back(write);
-        // }
-
-        std::vector<vk::WriteDescriptorSet> writes;
+        std::vector<uint32_t> bindings;
+        bindings.reserve(m_resources.size());
         for (const auto& [binding, resource] : m_resources)
         {
-            auto& write = writes.emplace_back();
-            write.setDstSet(m_descriptorSet);
-            write.setDstBinding(binding);
-            write.setDescriptorType(resource.Type);
-            write.setDescriptorCount(resource.Count);
+            bindings.push_back(binding);
+        }
+        std::sort(bindings.begin(), bindings.end());
+
+        // Lay all descriptors out back to back in binding order, for the update template to read them from. The key holds
+        // every field they are written from, rather than the raw slots whose padding is never initialised.
+        std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+        std::vector<DescriptorInfo> infos;
+        std::vector<uint64_t> key = { uint64_t(reinterpret_cast<uintptr_t>(m_layout.get())) };
+        for (const auto binding : bindings)
+        {
+            const auto& resource = m_resources.at(binding);
+
+            auto& entry = entries.emplace_back();
+            entry.setDstBinding(binding);
+            entry.setDescriptorType(resource.Type);
+            entry.setOffset(infos.size() * sizeof(DescriptorInfo));
+            entry.setStride(sizeof(DescriptorInfo));
+
+            key.push_back(binding);
+            key.push_back(uint64_t(resource.Type));
+            if (resource.Type == vk::DescriptorType::eUniformBuffer || resource.Type == vk::DescriptorType::eUniformBufferDynamic ||
+                resource.Type == vk::DescriptorType::eStorageBuffer)
+            {
+                entry.setDescriptorCount(1);
+                infos.emplace_back().Buffer = resource.BufferInfo;
 
-            if (resource.Type == vk::DescriptorType::eUniformBuffer)
+                key.push_back(uint64_t(VkBuffer(resource.BufferInfo.buffer)));
+                key.push_back(resource.BufferInfo.offset);
+                key.push_back(resource.BufferInfo.range);
+            }
+            else if (resource.Type == vk::DescriptorType::eCombinedImageSampler || resource.Type == vk::DescriptorType::eStorageImage)
             {
-                write.setBufferInfo(resource.BufferInfo);
+                entry.setDescriptorCount(uint32_t(resource.ImageInfos.size()));
+                key.push_back(resource.ImageInfos.size());
+                for (const auto& imageInfo : resource.ImageInfos)
+                {
+                    infos.emplace_back().Image = imageInfo;
+
+                    key.push_back(uint64_t(VkSampler(imageInfo.sampler)));
+                    key.push_back(uint64_t(VkImageView(imageInfo.imageView)));
+                    key.push_back(uint64_t(imageInfo.imageLayout));
+                }
             }
-            else if (resource.Type == vk::DescriptorType::eCombinedImageSampler)
+        }
+
+        if (m_perFrame)
+        {
+            // Another set of this frame may already hold exactly these descriptors
+            if (const auto cached = device.FindDescriptorSet(m_frameIndex, key))
             {
-                write.setImageInfo(resource.ImageInfos);
+                m_descriptorSet = cached;
+                return;
             }
+
+            // Only published once written, other recording threads may bind it as soon as it is in the cache
+            m_descriptorSet = device.AllocateDescriptorSet(m_frameIndex, *m_layout);
+            if (!entries.empty()) vkDevice.updateDescriptorSetWithTemplate(m_descriptorSet, m_layout->GetUpdateTemplate(entries), infos.data());
+
+            m_descriptorSet = device.CacheDescriptorSet(m_frameIndex, std::move(key), m_descriptorSet);
+            return;
         }
 
-        vkDevice.updateDescriptorSets(writes, {});
+        if (key == m_writtenKey) return;
+        m_writtenKey = std::move(key);
+
+        if (entries.empty()) return;
+
+        vkDevice.updateDescriptorSetWithTemplate(m_descriptorSet, m_layout->GetUpdateTemplate(entries), infos.data());
     }
 
     auto VulkanResourceSet::GetLayoutBinding(uint32_t binding) -> vk::DescriptorSetLayoutBinding*
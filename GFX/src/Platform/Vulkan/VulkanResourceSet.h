@@ -1,17 +1,20 @@
 ﻿#pragma once
 
 #include "GFX/Resources/ResourceSet.h"
+#include "VulkanLayoutCache.h"
 
 #include <vulkan/vulkan.hpp>
 
 #include <cstdint>
 #include <set>
+#include <vector>
 
 namespace gfx
 {
     class VulkanResourceSet : public ResourceSet
     {
     public:
+        // Per frame sets are allocated on UpdateBindings(), identical sets of the same frame share one descriptor set
         VulkanResourceSet(uint32_t frameIndex, uint32_t set, ResourceSetLayout* setLayout);
         VulkanResourceSet(uint32_t set, ResourceSetLayout* setLayout);
         ~VulkanResourceSet();
@@ -21,7 +24,10 @@ namespace gfx
         void CopyBindings(const ResourceSet& other) override;
 
         void SetUniformBuffer(uint32_t binding, UniformBuffer* buffer) override;
+        void SetDynamicUniformBuffer(uint32_t binding, Buffer* buffer, size_t range) override;
         void SetTextureSampler(uint32_t binding, uint32_t index, Texture* texture) override;
+        void SetStorageBuffer(uint32_t binding, Buffer* buffer, size_t offset, size_t range) override;
+        void SetStorageImage(uint32_t binding, Texture* texture) override;
 
         void UpdateBindings() override;
 
@@ -38,6 +44,13 @@ namespace gfx
             std::vector<vk::DescriptorImageInfo> ImageInfos{};
         };
 
+        // One slot of the data update templates read the descriptors from
+        union DescriptorInfo
+        {
+            VkDescriptorBufferInfo Buffer;
+            VkDescriptorImageInfo Image;
+        };
+
         auto GetLayoutBinding(uint32_t binding) -> vk::DescriptorSetLayoutBinding*;
 
     private:
@@ -45,9 +58,12 @@ namespace gfx
         std::vector<vk::DescriptorSetLayoutBinding> m_bindings;
 
         uint32_t m_set = 0;
+        bool m_perFrame = false;
+        uint32_t m_frameIndex = 0;
 
-        vk::DescriptorPool m_descriptorPool;
+        SharedPtr<const VulkanDescriptorSetLayout> m_layout;
         vk::DescriptorSet m_descriptorSet;
+        std::vector<uint64_t> m_writtenKey;  // Descriptors last written to a persistent set
 
         std::unordered_map<uint32_t, ResourceDecl> m_resources;
     };
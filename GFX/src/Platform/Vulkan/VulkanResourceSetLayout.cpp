@@ -14,7 +14,10 @@ namespace gfx
                 default:
                 case ResourceType::eNone: break;
                 case ResourceType::eUniformBuffer: return vk::DescriptorType::eUniformBuffer;
+                case ResourceType::eDynamicUniformBuffer: return vk::DescriptorType::eUniformBufferDynamic;
                 case ResourceType::eTextureSampler: return vk::DescriptorType::eCombinedImageSampler;
+                case ResourceType::eStorageBuffer: return vk::DescriptorType::eStorageBuffer;
+                case ResourceType::eStorageImage: return vk::DescriptorType::eStorageImage;
             }
             return {};
         }
@@ -34,15 +37,8 @@ namespace gfx
     void VulkanResourceSetLayout::Build()
     {
         auto* backend = VulkanBackend::Get();
-        auto& device = backend->GetDevice();
-        auto vkDevice = device.GetHandle();
 
-        auto bindings = GetBindings();
-
-        vk::DescriptorSetLayoutCreateInfo layoutInfo{};
-        layoutInfo.setBindings(bindings);
-
-        m_layout = vkDevice.createDescriptorSetLayout(layoutInfo);
+        m_layout = backend->GetLayoutCache().GetSetLayout(GetBindings());
     }
 
     auto VulkanResourceSetLayout::GetBindings() const -> std::vector<vk::DescriptorSetLayoutBinding>
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "GFX/Resources/ResourceSetLayout.h"
+#include "VulkanLayoutCache.h"
 
 #include <vulkan/vulkan.hpp>
 
@@ -15,16 +16,18 @@ namespace gfx
         VulkanResourceSetLayout() = default;
         ~VulkanResourceSetLayout() override = default;
 
-        auto GetHandle() const -> vk::DescriptorSetLayout { return m_layout; }
+        auto GetHandle() const -> vk::DescriptorSetLayout { return m_layout->Handle; }
+        auto GetLayout() const -> const SharedPtr<const VulkanDescriptorSetLayout>& { return m_layout; }
 
         void AddBinding(uint32_t binding, ResourceType type, size_t arraySize, ShaderStage shaderStage) override;
 
+        // Layouts with the same bindings share their vk::DescriptorSetLayout
         void Build() override;
 
         auto GetBindings() const -> std::vector<vk::DescriptorSetLayoutBinding>;
 
     private:
-        vk::DescriptorSetLayout m_layout;
+        SharedPtr<const VulkanDescriptorSetLayout> m_layout;
 
         std::unordered_map<uint32_t, vk::DescriptorSetLayoutBinding> m_bindings;
     };
@@ -0,0 +1,70 @@
+#include "VulkanSamplerCache.h"
+
+#include "GFX/Debug.h"
+#include "Utility/Hash.h"
+#include "VulkanDevice.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanUtils.h"
+
+#include <algorithm>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        auto HashSamplerDesc(const SamplerDesc& desc) -> uint64_t
+        {
+            auto hash = HashValue(desc.WrapU);
+            hash = HashValue(desc.WrapV, hash);
+            hash = HashValue(desc.WrapW, hash);
+            hash = HashValue(desc.MinFilter, hash);
+            hash = HashValue(desc.MagFilter, hash);
+            hash = HashValue(desc.MipFilter, hash);
+            return HashValue(desc.MaxAnisotropy, hash);
+        }
+    }
+
+    VulkanSamplerCache::VulkanSamplerCache(VulkanDevice& device, VulkanPhysicalDevice& physicalDevice)
+        : m_device(device.GetHandle())
+    {
+        if (physicalDevice.GetFeatures().samplerAnisotropy) m_maxAnisotropy = physicalDevice.GetProperties().limits.maxSamplerAnisotropy;
+    }
+
+    VulkanSamplerCache::~VulkanSamplerCache()
+    {
+        for (const auto& [hash, sampler] : m_samplers)
+        {
+            m_device.destroy(sampler);
+        }
+    }
+
+    auto VulkanSamplerCache::GetSampler(const SamplerDesc& desc) -> vk::Sampler
+    {
+        // Clamp first, so requests beyond the device limit share the sampler of the limit
+        auto clamped = desc;
+        clamped.MaxAnisotropy = std::clamp(desc.MaxAnisotropy, 1.0f, m_maxAnisotropy);
+        const auto hash = Utils::HashSamplerDesc(clamped);
+
+        std::lock_guard lock(m_mutex);
+        if (const auto it = m_samplers.find(hash); it != m_samplers.end()) return it->second;
+
+        vk::SamplerCreateInfo samplerInfo{};
+        samplerInfo.setAddressModeU(VkUtils::ToVkWrapMode(clamped.WrapU));
+        samplerInfo.setAddressModeV(VkUtils::ToVkWrapMode(clamped.WrapV));
+        samplerInfo.setAddressModeW(VkUtils::ToVkWrapMode(clamped.WrapW));
+        samplerInfo.setBorderColor(vk::BorderColor::eFloatTransparentBlack);
+        samplerInfo.setMinFilter(VkUtils::ToVkFilter(clamped.MinFilter));
+        samplerInfo.setMagFilter(VkUtils::ToVkFilter(clamped.MagFilter));
+        samplerInfo.setMipmapMode(VkUtils::ToVkMipmapMode(clamped.MipFilter));
+        samplerInfo.setAnisotropyEnable(clamped.MaxAnisotropy > 1.0f);
+        samplerInfo.setMaxAnisotropy(clamped.MaxAnisotropy);
+        // Every mip the texture has is sampled, textures without mips only have level 0
+        samplerInfo.setMinLod(0.0f);
+        samplerInfo.setMaxLod(VK_LOD_CLAMP_NONE);
+
+        const auto sampler = m_device.createSampler(samplerInfo);
+        m_samplers.emplace(hash, sampler);
+        GFX_TRACE("Created sampler {:x}, {} samplers in use.", hash, m_samplers.size());
+        return sampler;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "GFX/Resources/Texture.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace gfx
+{
+    class VulkanDevice;
+    class VulkanPhysicalDevice;
+
+    // Creates one sampler per distinct sampler state and keeps it alive until the backend is destroyed, so any number of
+    // textures share a handful of samplers and stay well within the device's sampler allocation limit.
+    class VulkanSamplerCache
+    {
+    public:
+        VulkanSamplerCache(VulkanDevice& device, VulkanPhysicalDevice& physicalDevice);
+        ~VulkanSamplerCache();
+
+        auto GetSampler(const SamplerDesc& desc) -> vk::Sampler;
+
+    private:
+        vk::Device m_device;
+        float m_maxAnisotropy = 1.0f;  // 1 if anisotropic filtering is unsupported
+
+        std::mutex m_mutex;
+        std::unordered_map<uint64_t, vk::Sampler> m_samplers;  // Hash of the clamped sampler state -> sampler
+    };
+}
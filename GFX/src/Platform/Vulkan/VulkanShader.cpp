@@ -6,57 +6,96 @@
 #include "VulkanDevice.h"
 #include "VulkanResourceSetLayout.h"
 #include "VulkanUtils.h"
+#include "Utility/Hash.h"
+#include "Utility/ParallelFor.h"
 
-#include <shaderc/shaderc.hpp>
-#include <spirv_cross/spirv_glsl.hpp>
+#include <algorithm>
+#include <future>
+#include <mutex>
 
 namespace gfx
 {
     namespace Utils
     {
-        auto VkShaderStageToShaderC(vk::ShaderStageFlagBits stage) -> shaderc_shader_kind
+        // Uniform blocks named e.g. `Object_Dynamic` are bound with dynamic offsets into transient uniform memory
+        bool IsDynamicUniformBuffer(const std::string& name) { return name.ends_with("_Dynamic"); }
+
+        auto GetStageSources(const ShaderSources& sources) -> std::vector<std::pair<vk::ShaderStageFlagBits, const std::string*>>
         {
-            switch (stage)
-            {
-                case vk::ShaderStageFlagBits::eVertex: return shaderc_vertex_shader;
-                case vk::ShaderStageFlagBits::eFragment: return shaderc_fragment_shader;
-                case vk::ShaderStageFlagBits::eCompute: return shaderc_compute_shader;
-            }
-            return (shaderc_shader_kind)0;
+            std::vector<std::pair<vk::ShaderStageFlagBits, const std::string*>> stages;
+            if (!sources.VertexSource.empty()) stages.emplace_back(vk::ShaderStageFlagBits::eVertex, &sources.VertexSource);
+            if (!sources.PixelSource.empty()) stages.emplace_back(vk::ShaderStageFlagBits::eFragment, &sources.PixelSource);
+            if (!sources.ComputeSource.empty()) stages.emplace_back(vk::ShaderStageFlagBits::eCompute, &sources.ComputeSource);
+            return stages;
         }
 
-        auto ToShaderUniformType(const spirv_cross::SPIRType& type)
+        bool IsTextureTableSet(const VulkanShader::ShaderDescriptorSet& set)
         {
-            switch (type.basetype)
-            {
-                case spirv_cross::SPIRType::Boolean: return ShaderUniformType::eBool;
-                case spirv_cross::SPIRType::Int: return ShaderUniformType::eInt;
-                case spirv_cross::SPIRType::UInt: return ShaderUniformType::eUInt;
-                case spirv_cross::SPIRType::Float: if (type.vecsize == 1) return ShaderUniformType::eFloat;
-                    if (type.vecsize == 2) return ShaderUniformType::eVec2;
-                    if (type.vecsize == 3) return ShaderUniformType::eVec3;
-                    if (type.vecsize == 4) return ShaderUniformType::eVec4;
-
-                    if (type.columns == 3) return ShaderUniformType::eMat3;
-                    if (type.columns == 4) return ShaderUniformType::eMat4;
-                    break;
-            }
-            return ShaderUniformType::eNone;
+            if (set.ImageSamplers.size() != 1 || !set.UniformBuffers.empty() || !set.StorageBuffers.empty() || !set.StorageImages.empty()) return false;
+
+            const auto& [binding, imageSampler] = *set.ImageSamplers.begin();
+            return binding == 0 && imageSampler.ArraySize == 0;
         }
     }
 
     static std::unordered_map<uint32_t, std::unordered_map<uint32_t, VulkanShader::UniformBuffer>> s_UniformBuffers; // set -> binding point -> buffer
+    static std::mutex s_UniformBuffersMutex;
     //    static std::unordered_map<uint32_t, std::unordered_map<uint32_t, VulkanShader::StorageBuffer*>> s_StorageBuffers;  // set -> binding point -> buffer
 
-    VulkanShader::VulkanShader(const std::string& vertexSource, const std::string& pixelSource)
+    auto VulkanShader::CreateBatch(const std::vector<ShaderSources>& sources) -> std::vector<OwnedPtr<Shader>>
+    {
+        auto& shaderCache = VulkanBackend::Get()->GetShaderCache();
+
+        struct StageSource
+        {
+            vk::ShaderStageFlagBits Stage;
+            const std::string* Source;
+            const std::string* SourcePath;
+        };
+
+        std::vector<StageSource> stageSources;
+        for (const auto& shaderSources : sources)
+        {
+            for (const auto& [stage, source] : Utils::GetStageSources(shaderSources))
+                stageSources.push_back({ stage, source, &shaderSources.SourcePath });
+        }
+
+        // Compile and reflect every stage of every shader across the worker threads, this warms the shader cache
+        ParallelFor(uint32_t(stageSources.size()),
+                    [&](uint32_t i)
+                    {
+                        const auto& stageSource = stageSources[i];
+                        shaderCache.GetOrCompile(stageSource.Stage, *stageSource.Source, *stageSource.SourcePath);
+                    });
+
+        // Creating the shaders now only hits the in-memory cache. It stays in order, so the shared uniform buffers
+        // merge exactly as if the shaders had been created one by one.
+        std::vector<OwnedPtr<Shader>> shaders;
+        shaders.reserve(sources.size());
+        for (const auto& shaderSources : sources)
+        {
+            shaders.push_back(CreateOwned<VulkanShader>(shaderSources));
+        }
+
+        return shaders;
+    }
+
+    VulkanShader::VulkanShader(const ShaderSources& sources, const std::vector<std::string>& defines, VulkanShader* base)
+        : m_sourcePath(sources.SourcePath),
+          m_keywords(sources.Keywords),
+          m_defines(defines),
+          m_base(base)
     {
-        m_shaderSources[vk::ShaderStageFlagBits::eVertex] = vertexSource;
-        m_shaderSources[vk::ShaderStageFlagBits::eFragment] = pixelSource;
+        for (const auto& [stage, source] : Utils::GetStageSources(sources))
+        {
+            m_shaderSources[stage] = *source;
+        }
 
         auto shaderData = Compile();
         LoadAndCreateShaders(shaderData);
         ReflectAllStages(shaderData);
         CreateDescriptors();
+        CreatePipelineLayout();
     }
 
     VulkanShader::~VulkanShader()
@@ -70,55 +109,160 @@ namespace gfx
         }
     }
 
+    auto VulkanShader::GetVariant(const std::vector<std::string>& keywords) -> Shader*
+    {
+        // Variants are always created from the original sources, so requesting a variant of a variant does not stack defines
+        if (m_base != nullptr) return m_base->GetVariant(keywords);
+
+        std::vector<std::string> defines;
+        for (const auto& keyword : keywords)
+        {
+            // Specialization constants are set per pipeline, the SPIR-V stays the same
+            if (IsSpecializationKeyword(keyword)) continue;
+
+            if (std::find(m_keywords.begin(), m_keywords.end(), keyword) == m_keywords.end())
+            {
+                GFX_WARN("Ignoring undeclared shader keyword '{}'!", keyword);
+                continue;
+            }
+
+            defines.push_back(keyword);
+        }
+
+        if (defines.empty()) return this;
+
+        std::sort(defines.begin(), defines.end());
+        defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+
+        std::string name;
+        for (const auto& define : defines)
+        {
+            if (!name.empty()) name += ' ';
+            name += define;
+        }
+
+        std::lock_guard lock(m_variantsMutex);
+        auto& variant = m_variants[name];
+        if (variant == nullptr)
+        {
+            ShaderSources sources{};
+            for (const auto& [stage, source] : m_shaderSources)
+            {
+                if (stage == vk::ShaderStageFlagBits::eVertex) sources.VertexSource = source;
+                if (stage == vk::ShaderStageFlagBits::eFragment) sources.PixelSource = source;
+                if (stage == vk::ShaderStageFlagBits::eCompute) sources.ComputeSource = source;
+            }
+            sources.SourcePath = m_sourcePath;
+            sources.Keywords = m_keywords;
+
+            GFX_TRACE("Compiling shader variant '{}'", name);
+            variant = CreateOwned<VulkanShader>(sources, defines, this);
+        }
+
+        return variant.get();
+    }
+
+    bool VulkanShader::IsSpecializationKeyword(const std::string& keyword) const
+    {
+        const auto it = m_specializationConstants.find(keyword);
+        return it != m_specializationConstants.end() && it->second.Type == ShaderUniformType::eBool;
+    }
+
     auto VulkanShader::GetDescriptorSetLayouts() const -> std::vector<vk::DescriptorSetLayout>
     {
         std::vector<vk::DescriptorSetLayout> layouts;
 
-        for (auto& set : m_resourceSetLayouts)
+        for (uint32_t set = 0; set < m_resourceSetLayouts.size(); set++)
         {
-            auto* vkSet = static_cast<VulkanResourceSetLayout*>(set.get());
+            if (set == m_textureTableSet)
+            {
+                layouts.emplace_back(VulkanBackend::Get()->GetTextureTable().GetLayout()->Handle);
+                continue;
+            }
+
+            auto* vkSet = static_cast<VulkanResourceSetLayout*>(m_resourceSetLayouts[set].get());
             layouts.emplace_back(vkSet->GetHandle());
         }
 
         return layouts;
     }
 
-    auto VulkanShader::Compile() -> std::unordered_map<vk::ShaderStageFlagBits, std::vector<uint32_t>>
+    void VulkanShader::CreatePipelineLayout()
     {
-        std::unordered_map<vk::ShaderStageFlagBits, std::vector<uint32_t>> shaderData;
+        std::vector<vk::PushConstantRange> vkPushConstantRanges(m_pushConstantRanges.size());
+        for (size_t i = 0; i < m_pushConstantRanges.size(); i++)
+        {
+            const auto& pushConstantRange = m_pushConstantRanges[i];
+            auto& vkPushConstantRange = vkPushConstantRanges[i];
+
+            vkPushConstantRange.stageFlags = pushConstantRange.ShaderStage;
+            vkPushConstantRange.offset = (uint32_t)pushConstantRange.Offset;
+            vkPushConstantRange.size = (uint32_t)pushConstantRange.Size;
+        }
 
-        for (auto& [stage, source] : m_shaderSources)
+        std::vector<SharedPtr<const VulkanDescriptorSetLayout>> setLayouts;
+        for (uint32_t set = 0; set < m_resourceSetLayouts.size(); set++)
         {
-            shaderc::Compiler compiler;
-            shaderc::CompileOptions options;
-            options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
-            options.SetWarningsAsErrors();
-            options.SetGenerateDebugInfo();
+            if (set == m_textureTableSet)
+                setLayouts.push_back(VulkanBackend::Get()->GetTextureTable().GetLayout());
+            else
+                setLayouts.push_back(static_cast<VulkanResourceSetLayout*>(m_resourceSetLayouts[set].get())->GetLayout());
+        }
+
+        m_pipelineLayout = VulkanBackend::Get()->GetLayoutCache().GetPipelineLayout(setLayouts, vkPushConstantRanges);
+    }
 
-            const bool optimize = false;
-            if (optimize) options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    void VulkanShader::GetSpecializationData(const std::vector<std::string>& keywords,
+                                             std::vector<vk::SpecializationMapEntry>& entries,
+                                             std::vector<vk::Bool32>& data) const
+    {
+        for (const auto& keyword : keywords)
+        {
+            if (!IsSpecializationKeyword(keyword)) continue;
+
+            const auto constantID = m_specializationConstants.at(keyword).ConstantID;
+            const bool duplicate = std::any_of(entries.begin(), entries.end(), [&](const auto& entry) { return entry.constantID == constantID; });
+            if (duplicate) continue;
+
+            entries.emplace_back(constantID, uint32_t(data.size() * sizeof(vk::Bool32)), sizeof(vk::Bool32));
+            data.push_back(VK_TRUE);
+        }
+    }
+
+    auto VulkanShader::Compile() -> ShaderData
+    {
+        auto& shaderCache = VulkanBackend::Get()->GetShaderCache();
 
-            // Compile Shader
+        ShaderData shaderData;
+        std::vector<std::pair<vk::ShaderStageFlagBits, std::future<SharedPtr<const VulkanShaderCache::Entry>>>> pendingStages;
+        for (const auto& pair : m_shaderSources)
+        {
+            const auto stage = pair.first;
+            const auto& source = pair.second;
+
+            auto entry = shaderCache.Find(stage, source, m_sourcePath, m_defines);
+            if (entry != nullptr)
             {
-                auto& shaderSource = m_shaderSources.at(stage);
-                auto module = compiler.CompileGlslToSpv(shaderSource, Utils::VkShaderStageToShaderC(stage), "", options);
-                if (module.GetCompilationStatus() != shaderc_compilation_status_success)
-                {
-                    GFX_ERROR("Shader Error | Stage = {} \n{}", vk::to_string(stage), module.GetErrorMessage());
-                }
-
-                const auto* begin = (const uint8_t*)module.cbegin();
-                const auto* end = (const uint8_t*)module.cend();
-                const auto size = end - begin;
-
-                shaderData[stage] = std::vector<uint32_t>(module.cbegin(), module.cend());
+                shaderData[stage] = std::move(entry);
+                continue;
             }
+
+            // Stages missing from the cache are compiled concurrently
+            auto compile = [this, &shaderCache, stage, &source]() { return shaderCache.GetOrCompile(stage, source, m_sourcePath, m_defines); };
+            pendingStages.emplace_back(stage, std::async(std::launch::async, compile));
+        }
+
+        for (auto& [stage, future] : pendingStages)
+        {
+            // Failed stages have already been reported by the cache
+            auto entry = future.get();
+            if (entry != nullptr) shaderData[stage] = std::move(entry);
         }
 
         return shaderData;
     }
 
-    void VulkanShader::LoadAndCreateShaders(const std::unordered_map<vk::ShaderStageFlagBits, std::vector<uint32_t>>& shaderData)
+    void VulkanShader::LoadAndCreateShaders(const ShaderData& shaderData)
     {
         auto* backend = VulkanBackend::Get();
         auto vkDevice = backend->GetDevice().GetHandle();
@@ -126,7 +270,7 @@ namespace gfx
         for (auto& [stage, data] : shaderData)
         {
             vk::ShaderModuleCreateInfo moduleInfo{};
-            moduleInfo.setCode(data);
+            moduleInfo.setCode(data->Spirv);
 
             auto module = vkDevice.createShaderModule(moduleInfo);
 
@@ -134,28 +278,21 @@ namespace gfx
             shaderStage.setStage(stage);
             shaderStage.setModule(module);
             shaderStage.setPName("main");
+
+            // Combined order independently, the stages are not stored in a fixed order
+            m_hash ^= HashBytes(data->Spirv.data(), data->Spirv.size() * sizeof(uint32_t), HashValue(stage));
+            m_stageCode.emplace_back(stage, data);
         }
+
+        std::sort(m_stageCode.begin(), m_stageCode.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
     }
 
-    void VulkanShader::Reflect(vk::ShaderStageFlagBits stage, const std::vector<uint32_t>& data)
+    void VulkanShader::Reflect(vk::ShaderStageFlagBits stage, const VulkanShaderReflection& reflection)
     {
-        GFX_TRACE("===========================");
-        GFX_TRACE(" Vulkan Shader Reflection");
-        GFX_TRACE(" Stage: {}", vk::to_string(stage));
-        GFX_TRACE("===========================");
-
-        spirv_cross::Compiler compiler(data);
-        auto resources = compiler.get_shader_resources();
-
-        GFX_TRACE("Uniform Buffers");
-        for (const auto& resource : resources.uniform_buffers)
+        for (const auto& resource : reflection.UniformBuffers)
         {
-            const auto& bufferName = resource.name;
-            auto& bufferType = compiler.get_type(resource.base_type_id);
-            auto bufferSize = compiler.get_declared_struct_size(bufferType);
-            auto memberCount = bufferType.member_types.size();
-            uint32_t binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
-            uint32_t descriptorSet = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            const auto descriptorSet = resource.Set;
+            const auto binding = resource.Binding;
 
             if (descriptorSet >= m_shaderDescriptorSets.size()) m_shaderDescriptorSets.resize(descriptorSet + 1);
 
@@ -164,30 +301,23 @@ namespace gfx
             {
                 auto& uniformBuffer = s_UniformBuffers.at(descriptorSet)[binding];
                 uniformBuffer.BindingPoint = binding;
-                uniformBuffer.Size = bufferSize;
-                uniformBuffer.Name = bufferName;
+                uniformBuffer.Size = resource.Size;
+                uniformBuffer.Name = resource.Name;
                 uniformBuffer.ShaderStage = stage;
+                uniformBuffer.Dynamic = Utils::IsDynamicUniformBuffer(resource.Name);
             }
             else
             {
                 auto& uniformBuffer = s_UniformBuffers.at(descriptorSet).at(binding);
-                if (bufferSize > uniformBuffer.Size) uniformBuffer.Size = bufferSize;
+                if (resource.Size > uniformBuffer.Size) uniformBuffer.Size = resource.Size;
             }
 
             shaderDescriptorSet.UniformBuffers[binding] = s_UniformBuffers.at(descriptorSet).at(binding);
-
-            GFX_TRACE("  {} ({}, {})", bufferName, descriptorSet, binding);
-            GFX_TRACE("    Member Count: {}", memberCount);
-            GFX_TRACE("    Size: {}", bufferSize);
         }
 
-        GFX_TRACE("Push Constant Buffers: ");
-        for (const auto& resource : resources.push_constant_buffers)
+        for (const auto& resource : reflection.PushConstantBuffers)
         {
-            const auto& bufferName = resource.name;
-            auto& bufferType = compiler.get_type(resource.base_type_id);
-            auto bufferSize = compiler.get_declared_struct_size(bufferType);
-            auto memberCount = bufferType.member_types.size();
+            const auto& bufferName = resource.Name;
             size_t bufferOffset = 0;
             if (!m_pushConstantRanges.empty())
             {
@@ -197,67 +327,80 @@ namespace gfx
             auto& pushConstantRange = m_pushConstantRanges.emplace_back();
             pushConstantRange.ShaderStage = stage;
             pushConstantRange.Offset = bufferOffset;
-            pushConstantRange.Size = bufferSize;
+            pushConstantRange.Size = resource.Size;
 
             //  Skip empty push constant buffers - these are for the renderer only
             if (bufferName.empty() || bufferName == "u_Renderer") continue;
 
             ShaderBuffer& buffer = m_buffers[bufferName];
             buffer.Name = bufferName;
-            buffer.Size = bufferSize - bufferOffset;
-
-            GFX_TRACE("  Name: {}", bufferName);
-            GFX_TRACE("    Member Count: {}", memberCount);
-            GFX_TRACE("    Size: {}", bufferSize);
+            buffer.Size = resource.Size - bufferOffset;
 
-            for (int i = 0; i < memberCount; i++)
+            for (const auto& member : resource.Members)
             {
-                auto& type = compiler.get_type(bufferType.member_types[i]);
-                const auto& memberName = compiler.get_member_name(bufferType.self, i);
-                auto size = compiler.get_declared_struct_member_size(bufferType, i);
-                auto offset = compiler.type_struct_member_offset(bufferType, i) - bufferOffset;
-
-                std::string uniformName = bufferName + "." + memberName;
-                buffer.Uniforms[uniformName] = ShaderUniform(uniformName, Utils::ToShaderUniformType(type), size, offset);
+                std::string uniformName = bufferName + "." + member.Name;
+                buffer.Uniforms[uniformName] = ShaderUniform(uniformName, member.Type, member.Size, member.Offset - bufferOffset);
             }
         }
 
-        GFX_TRACE("Sampled Images: ");
-        for (const auto& resource : resources.sampled_images)
+        for (const auto& resource : reflection.SampledImages)
         {
-            const auto& name = resource.name;
-//            auto& baseType = compiler.get_type(resource.base_type_id);
-            auto& type = compiler.get_type(resource.type_id);
-            uint32_t binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
-            uint32_t descriptorSet = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
-//            uint32_t dimension = baseType.image.dim;
-            uint32_t arraySize = type.array[0];
-            if (arraySize == 0) arraySize = 1;
-            if (descriptorSet >= m_shaderDescriptorSets.size()) m_shaderDescriptorSets.resize(descriptorSet + 1);
-
-            auto& shaderDescriptorSet = m_shaderDescriptorSets[descriptorSet];
-            auto& imageSampler = shaderDescriptorSet.ImageSamplers[binding];
-            imageSampler.BindingPoint = binding;
-            imageSampler.DescriptorSet = descriptorSet;
-            imageSampler.Name = name;
-            imageSampler.ArraySize = arraySize;
+            if (resource.Set >= m_shaderDescriptorSets.size()) m_shaderDescriptorSets.resize(resource.Set + 1);
+
+            auto& shaderDescriptorSet = m_shaderDescriptorSets[resource.Set];
+            auto& imageSampler = shaderDescriptorSet.ImageSamplers[resource.Binding];
+            imageSampler.BindingPoint = resource.Binding;
+            imageSampler.DescriptorSet = resource.Set;
+            imageSampler.Name = resource.Name;
+            imageSampler.ArraySize = resource.ArraySize;
             imageSampler.ShaderStage = stage;
 
-            m_resources[name] = ShaderResourceDeclaration(name, binding, 1);
+            m_resources[resource.Name] = ShaderResourceDeclaration(resource.Name, resource.Binding, 1);
+        }
 
-            GFX_TRACE("  {}[{}] (set={}, binding={})", name, arraySize,descriptorSet, binding);
+        for (const auto& resource : reflection.StorageBuffers)
+        {
+            if (resource.Set >= m_shaderDescriptorSets.size()) m_shaderDescriptorSets.resize(resource.Set + 1);
+
+            auto& storageBuffer = m_shaderDescriptorSets[resource.Set].StorageBuffers[resource.Binding];
+            storageBuffer.BindingPoint = resource.Binding;
+            storageBuffer.Name = resource.Name;
+            storageBuffer.ShaderStage = stage;
+
+            m_resources[resource.Name] = ShaderResourceDeclaration(resource.Name, resource.Binding, 1);
+        }
+
+        for (const auto& resource : reflection.StorageImages)
+        {
+            if (resource.Set >= m_shaderDescriptorSets.size()) m_shaderDescriptorSets.resize(resource.Set + 1);
+
+            auto& storageImage = m_shaderDescriptorSets[resource.Set].StorageImages[resource.Binding];
+            storageImage.BindingPoint = resource.Binding;
+            storageImage.DescriptorSet = resource.Set;
+            storageImage.Name = resource.Name;
+            storageImage.ArraySize = resource.ArraySize;
+            storageImage.ShaderStage = stage;
+
+            m_resources[resource.Name] = ShaderResourceDeclaration(resource.Name, resource.Binding, 1);
         }
 
-        GFX_TRACE("===========================");
+        for (const auto& resource : reflection.SpecializationConstants)
+        {
+            auto& specializationConstant = m_specializationConstants[resource.Name];
+            specializationConstant.ConstantID = resource.ConstantID;
+            specializationConstant.Type = resource.Type;
+        }
     }
 
-    void VulkanShader::ReflectAllStages(const std::unordered_map<vk::ShaderStageFlagBits, std::vector<uint32_t>>& shaderData)
+    void VulkanShader::ReflectAllStages(const ShaderData& shaderData)
     {
         // m_resources.clear();
 
+        std::lock_guard lock(s_UniformBuffersMutex);
+
         for (auto& [stage, data] : shaderData)
         {
-            Reflect(stage, data);
+            Reflect(stage, data->Reflection);
         }
     }
 
@@ -265,19 +408,49 @@ namespace gfx
     {
         auto* backend = VulkanBackend::Get();
         auto vkDevice = backend->GetDevice().GetHandle();
+        const bool textureTableSupported = backend->GetTextureTable().IsSupported();
 
         m_typeCounts.clear();
+        m_textureTableSet = UINT32_MAX;
         m_resourceSetLayouts.resize(m_shaderDescriptorSets.size());
         for (uint32_t set = 0; set < m_shaderDescriptorSets.size(); set++)
         {
             auto& shaderSet = m_shaderDescriptorSets[set];
             auto& layout = m_resourceSetLayouts[set] = ResourceSetLayout::Create();
 
-            if (!shaderSet.UniformBuffers.empty())
+            // A runtime sized sampler array alone in its set is the global texture table, which is bound by the command buffer
+            if (textureTableSupported && Utils::IsTextureTableSet(shaderSet))
+            {
+                GFX_ASSERT(m_textureTableSet == UINT32_MAX, "Only one set can declare the texture table!");
+                m_textureTableSet = set;
+
+                layout->Build();
+                GFX_INFO("Using descriptor set {} as the texture table", set);
+                continue;
+            }
+
+            for (auto& [binding, imageSampler] : shaderSet.ImageSamplers)
+            {
+                if (imageSampler.ArraySize != 0) continue;
+
+                GFX_ERROR("Runtime sized sampler array '{}' is only supported as the texture table, alone at binding 0 of its set!", imageSampler.Name);
+                imageSampler.ArraySize = 1;
+            }
+
+            const size_t dynamicCount = std::count_if(shaderSet.UniformBuffers.begin(),
+                                                      shaderSet.UniformBuffers.end(),
+                                                      [](const auto& pair) { return pair.second.Dynamic; });
+            if (shaderSet.UniformBuffers.size() > dynamicCount)
             {
                 auto& typeCount = m_typeCounts[set].emplace_back();
                 typeCount.setType(vk::DescriptorType::eUniformBuffer);
-                typeCount.setDescriptorCount((uint32_t)shaderSet.UniformBuffers.size());
+                typeCount.setDescriptorCount((uint32_t)(shaderSet.UniformBuffers.size() - dynamicCount));
+            }
+            if (dynamicCount > 0)
+            {
+                auto& typeCount = m_typeCounts[set].emplace_back();
+                typeCount.setType(vk::DescriptorType::eUniformBufferDynamic);
+                typeCount.setDescriptorCount((uint32_t)dynamicCount);
             }
             if (!shaderSet.ImageSamplers.empty())
             {
@@ -285,21 +458,36 @@ namespace gfx
                 typeCount.setType(vk::DescriptorType::eCombinedImageSampler);
                 typeCount.setDescriptorCount((uint32_t)shaderSet.ImageSamplers.size());
             }
+            if (!shaderSet.StorageBuffers.empty())
+            {
+                auto& typeCount = m_typeCounts[set].emplace_back();
+                typeCount.setType(vk::DescriptorType::eStorageBuffer);
+                typeCount.setDescriptorCount((uint32_t)shaderSet.StorageBuffers.size());
+            }
+            if (!shaderSet.StorageImages.empty())
+            {
+                auto& typeCount = m_typeCounts[set].emplace_back();
+                typeCount.setType(vk::DescriptorType::eStorageImage);
+                typeCount.setDescriptorCount((uint32_t)shaderSet.StorageImages.size());
+            }
 
             /* Descriptor Set Layout */
             std::vector<vk::DescriptorSetLayoutBinding> layoutBindings;
             for (auto& [binding, uniformBuffer] : shaderSet.UniformBuffers)
             {
+                const auto descriptorType = uniformBuffer.Dynamic ? vk::DescriptorType::eUniformBufferDynamic : vk::DescriptorType::eUniformBuffer;
+                const auto resourceType = uniformBuffer.Dynamic ? ResourceType::eDynamicUniformBuffer : ResourceType::eUniformBuffer;
+
                 auto& layoutBinding = layoutBindings.emplace_back();
-                layoutBinding.setDescriptorType(vk::DescriptorType::eUniformBuffer);
+                layoutBinding.setDescriptorType(descriptorType);
                 layoutBinding.setDescriptorCount(1);
                 layoutBinding.setStageFlags(uniformBuffer.ShaderStage);
                 layoutBinding.setBinding(binding);
 
-                layout->AddBinding(binding, ResourceType::eUniformBuffer, 1, VkUtils::ToShaderStage(uniformBuffer.ShaderStage));
+                layout->AddBinding(binding, resourceType, 1, VkUtils::ToShaderStage(uniformBuffer.ShaderStage));
 
                 auto& writeSet = shaderSet.WriteDescriptorSets[uniformBuffer.Name];
-                writeSet.setDescriptorType(vk::DescriptorType::eUniformBuffer);
+                writeSet.setDescriptorType(descriptorType);
                 writeSet.setDescriptorCount(1);
                 writeSet.setDstBinding(layoutBinding.binding);
             }
@@ -320,13 +508,45 @@ namespace gfx
                 writeSet.setDescriptorCount((uint32_t)imageSampler.ArraySize);
                 writeSet.setDstBinding(layoutBinding.binding);
             }
+            for (auto& [binding, storageBuffer] : shaderSet.StorageBuffers)
+            {
+                auto& layoutBinding = layoutBindings.emplace_back();
+                layoutBinding.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+                layoutBinding.setDescriptorCount(1);
+                layoutBinding.setStageFlags(storageBuffer.ShaderStage);
+                layoutBinding.setBinding(binding);
+
+                layout->AddBinding(binding, ResourceType::eStorageBuffer, 1, VkUtils::ToShaderStage(storageBuffer.ShaderStage));
+
+                auto& writeSet = shaderSet.WriteDescriptorSets[storageBuffer.Name];
+                writeSet.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+                writeSet.setDescriptorCount(1);
+                writeSet.setDstBinding(layoutBinding.binding);
+            }
+            for (auto& [binding, storageImage] : shaderSet.StorageImages)
+            {
+                auto& layoutBinding = layoutBindings.emplace_back();
+                layoutBinding.setDescriptorType(vk::DescriptorType::eStorageImage);
+                layoutBinding.setDescriptorCount((uint32_t)storageImage.ArraySize);
+                layoutBinding.setStageFlags(storageImage.ShaderStage);
+                layoutBinding.setBinding(binding);
+
+                layout->AddBinding(binding, ResourceType::eStorageImage, storageImage.ArraySize, VkUtils::ToShaderStage(storageImage.ShaderStage));
+
+                auto& writeSet = shaderSet.WriteDescriptorSets[storageImage.Name];
+                writeSet.setDescriptorType(vk::DescriptorType::eStorageImage);
+                writeSet.setDescriptorCount((uint32_t)storageImage.ArraySize);
+                writeSet.setDstBinding(layoutBinding.binding);
+            }
 
             layout->Build();
 
-            GFX_INFO("Creating descriptor set {} with {} ubo's and {} samplers",
+            GFX_INFO("Creating descriptor set {} with {} ubo's, {} samplers, {} storage buffers and {} storage images",
                      set,
                      shaderSet.UniformBuffers.size(),
-                     shaderSet.ImageSamplers.size());
+                     shaderSet.ImageSamplers.size(),
+                     shaderSet.StorageBuffers.size(),
+                     shaderSet.StorageImages.size());
         }
     }
 }
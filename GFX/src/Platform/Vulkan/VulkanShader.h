@@ -1,10 +1,13 @@
 ﻿#pragma once
 
 #include "GFX/Resources/Shader.h"
+#include "VulkanShaderCache.h"
+#include "VulkanLayoutCache.h"
 
 #include <vulkan/vulkan.hpp>
 
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -23,6 +26,7 @@ namespace gfx
             uint32_t BindingPoint = 0;
             std::string Name;
             vk::ShaderStageFlagBits ShaderStage = {};
+            bool Dynamic = false;
         };
 
         struct PushConstantRange
@@ -41,10 +45,19 @@ namespace gfx
             vk::ShaderStageFlagBits ShaderStage = {};
         };
 
+        struct StorageBuffer
+        {
+            uint32_t BindingPoint = 0;
+            std::string Name;
+            vk::ShaderStageFlagBits ShaderStage = {};
+        };
+
         struct ShaderDescriptorSet
         {
             std::unordered_map<uint32_t, UniformBuffer> UniformBuffers;
             std::unordered_map<uint32_t, ImageSampler> ImageSamplers;
+            std::unordered_map<uint32_t, StorageBuffer> StorageBuffers;
+            std::unordered_map<uint32_t, ImageSampler> StorageImages;
 
             std::unordered_map<std::string, vk::WriteDescriptorSet> WriteDescriptorSets;
 
@@ -57,33 +70,80 @@ namespace gfx
             std::vector<vk::DescriptorSet> DescriptorSets;
         };
 
+        struct SpecializationConstant
+        {
+            uint32_t ConstantID = 0;
+            ShaderUniformType Type = ShaderUniformType::eNone;
+        };
+
     public:
-        VulkanShader(const std::string& vertexSource, const std::string& pixelSource);
+        static auto CreateBatch(const std::vector<ShaderSources>& sources) -> std::vector<OwnedPtr<Shader>>;
+
+        // `base` is the shader a variant was created from, variants compile `defines` on top of its sources
+        VulkanShader(const ShaderSources& sources, const std::vector<std::string>& defines = {}, VulkanShader* base = nullptr);
         ~VulkanShader();
 
         auto GetShaderBuffers() const -> const std::unordered_map<std::string, ShaderBuffer>& override { return m_buffers; }
         auto GetShaderResources() const -> const std::unordered_map<std::string, ShaderResourceDeclaration>& override { return m_resources; }
 
+        auto GetKeywords() const -> const std::vector<std::string>& override { return m_keywords; }
+        auto GetVariant(const std::vector<std::string>& keywords) -> Shader* override;
+
+        // Specialization constants of all stages by name
+        auto GetSpecializationConstants() const -> const std::unordered_map<std::string, SpecializationConstant>& { return m_specializationConstants; }
+        bool IsSpecializationKeyword(const std::string& keyword) const;
+
         auto GetShaderStageCreateInfos() const -> const std::vector<vk::PipelineShaderStageCreateInfo>& { return m_pipelineShaderStageCreateInfos; }
+        bool IsCompute() const { return m_shaderSources.contains(vk::ShaderStageFlagBits::eCompute); }
+        // File the shader was loaded from, empty if it was created from source strings
+        auto GetSourcePath() const -> const std::string& { return m_sourcePath; }
+        // Hash of the SPIR-V of all stages, shaders with the same hash are likely interchangeable, see GetStageCode()
+        auto GetHash() const -> uint64_t { return m_hash; }
+        // Compiled code of every stage ordered by stage, shaders with equal SPIR-V for every stage are interchangeable
+        auto GetStageCode() const -> const std::vector<std::pair<vk::ShaderStageFlagBits, SharedPtr<const VulkanShaderCache::Entry>>>&
+        {
+            return m_stageCode;
+        }
 
         auto GetPushConstantRanges() const -> const std::vector<PushConstantRange>& { return m_pushConstantRanges; }
         auto GetDescriptorSetLayouts() const -> std::vector<vk::DescriptorSetLayout>;
+        // Interned, shaders with the same resources and push constants share their pipeline layout
+        auto GetPipelineLayout() const -> const SharedPtr<const VulkanPipelineLayout>& { return m_pipelineLayout; }
+        // Fills the specialization data enabling the specialization constant `keywords`, one set of data serves all stages
+        void GetSpecializationData(const std::vector<std::string>& keywords,
+                                   std::vector<vk::SpecializationMapEntry>& entries,
+                                   std::vector<vk::Bool32>& data) const;
 
     private:
-        auto Compile() -> std::unordered_map<vk::ShaderStageFlagBits, std::vector<uint32_t>>;
-        void LoadAndCreateShaders(const std::unordered_map<vk::ShaderStageFlagBits, std::vector<uint32_t>>& shaderData);
-        void Reflect(vk::ShaderStageFlagBits stage, const std::vector<uint32_t>& data);
-        void ReflectAllStages(const std::unordered_map<vk::ShaderStageFlagBits, std::vector<uint32_t>>& shaderData);
+        using ShaderData = std::unordered_map<vk::ShaderStageFlagBits, SharedPtr<const VulkanShaderCache::Entry>>;
+
+        auto Compile() -> ShaderData;
+        void LoadAndCreateShaders(const ShaderData& shaderData);
+        void Reflect(vk::ShaderStageFlagBits stage, const VulkanShaderReflection& reflection);
+        void ReflectAllStages(const ShaderData& shaderData);
         void CreateDescriptors();
+        void CreatePipelineLayout();
 
     private:
         std::unordered_map<vk::ShaderStageFlagBits, std::string> m_shaderSources;
+        std::string m_sourcePath;
+        std::vector<std::string> m_keywords;
+        std::vector<std::string> m_defines;
         std::vector<vk::PipelineShaderStageCreateInfo> m_pipelineShaderStageCreateInfos;
+        uint64_t m_hash = 0;
+        std::vector<std::pair<vk::ShaderStageFlagBits, SharedPtr<const VulkanShaderCache::Entry>>> m_stageCode;
+
+        VulkanShader* m_base = nullptr;
+        std::mutex m_variantsMutex;
+        std::unordered_map<std::string, OwnedPtr<VulkanShader>> m_variants;  // Sorted defines joined by spaces -> variant
+        std::unordered_map<std::string, SpecializationConstant> m_specializationConstants;
 
         std::vector<ShaderDescriptorSet> m_shaderDescriptorSets;
+        uint32_t m_textureTableSet = UINT32_MAX;  // Set declaring the global texture table, its layout is the table's
         std::unordered_map<std::string, ShaderResourceDeclaration> m_resources;
 
         std::vector<PushConstantRange> m_pushConstantRanges;
+        SharedPtr<const VulkanPipelineLayout> m_pipelineLayout;
         std::unordered_map<std::string, ShaderBuffer> m_buffers;
 
         /* Descriptors */
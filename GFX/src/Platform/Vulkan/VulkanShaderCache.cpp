@@ -0,0 +1,370 @@
+#include "VulkanShaderCache.h"
+
+#include "GFX/Config.h"
+#include "GFX/Debug.h"
+#include "Utility/Hash.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        // Bump whenever the way modules are compiled changes in a way the options hash does not capture
+        constexpr uint32_t ShaderCacheVersion = 1;
+
+        constexpr uint32_t SpirvMagic = 0x07230203;
+
+        constexpr auto ShaderTargetEnv = shaderc_target_env_vulkan;
+        constexpr auto ShaderTargetEnvVersion = shaderc_env_version_vulkan_1_2;
+        constexpr auto ShaderOptimizationLevel = shaderc_optimization_level_zero;
+
+        auto VkShaderStageToShaderC(vk::ShaderStageFlagBits stage) -> shaderc_shader_kind
+        {
+            switch (stage)
+            {
+                case vk::ShaderStageFlagBits::eVertex: return shaderc_vertex_shader;
+                case vk::ShaderStageFlagBits::eFragment: return shaderc_fragment_shader;
+                case vk::ShaderStageFlagBits::eCompute: return shaderc_compute_shader;
+            }
+            return (shaderc_shader_kind)0;
+        }
+
+        // Resolves #include directives through the shader cache, recording every file it hands out
+        class ShaderIncluder : public shaderc::CompileOptions::IncluderInterface
+        {
+        public:
+            ShaderIncluder(VulkanShaderCache& cache, std::filesystem::path rootDirectory, std::vector<VulkanShaderCache::Dependency>& dependencies)
+                : m_cache(cache), m_rootDirectory(std::move(rootDirectory)), m_dependencies(dependencies)
+            {
+            }
+
+            auto GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t) -> shaderc_include_result* override
+            {
+                // "file" is relative to the including file, <file> to the shader being compiled
+                const auto directory = type == shaderc_include_type_relative ? std::filesystem::path(requestingSource).parent_path() : m_rootDirectory;
+                const auto path = (directory / requestedSource).lexically_normal();
+
+                auto* result = new IncludeResult();
+                result->Include = m_cache.GetInclude(path);
+                if (result->Include == nullptr)
+                {
+                    // An empty source name tells shaderc the include failed, the content holds the error message
+                    result->Content = fmt::format("Cannot open include file '{}'", path.generic_string());
+                }
+                else
+                {
+                    result->SourceName = path.generic_string();
+                    result->Content = result->Include->Content;
+
+                    const bool recorded = std::any_of(
+                        m_dependencies.begin(), m_dependencies.end(), [&](const auto& dependency) { return dependency.Path == result->SourceName; });
+                    if (!recorded) m_dependencies.push_back({ result->SourceName, result->Include->Hash });
+                }
+
+                result->Result.source_name = result->SourceName.data();
+                result->Result.source_name_length = result->SourceName.size();
+                result->Result.content = result->Content.data();
+                result->Result.content_length = result->Content.size();
+                result->Result.user_data = result;
+                return &result->Result;
+            }
+
+            void ReleaseInclude(shaderc_include_result* data) override { delete static_cast<IncludeResult*>(data->user_data); }
+
+        private:
+            struct IncludeResult
+            {
+                shaderc_include_result Result{};
+                std::string SourceName;
+                std::string Content;
+                SharedPtr<const VulkanShaderCache::Include> Include;
+            };
+
+        private:
+            VulkanShaderCache& m_cache;
+            std::filesystem::path m_rootDirectory;
+            std::vector<VulkanShaderCache::Dependency>& m_dependencies;
+        };
+    }
+
+    VulkanShaderCache::VulkanShaderCache(const std::string& directory)
+    {
+        m_options.SetTargetEnvironment(Utils::ShaderTargetEnv, Utils::ShaderTargetEnvVersion);
+        m_options.SetWarningsAsErrors();
+        m_options.SetOptimizationLevel(Utils::ShaderOptimizationLevel);
+        if (Config::ShaderDebugInfo) m_options.SetGenerateDebugInfo();
+
+        m_optionsHash = HashValue(Utils::ShaderCacheVersion);
+        m_optionsHash = HashValue(Utils::ShaderTargetEnv, m_optionsHash);
+        m_optionsHash = HashValue(Utils::ShaderTargetEnvVersion, m_optionsHash);
+        m_optionsHash = HashValue(Utils::ShaderOptimizationLevel, m_optionsHash);
+        m_optionsHash = HashValue(Config::ShaderDebugInfo, m_optionsHash);
+
+        if (!directory.empty())
+        {
+            m_directory = directory;
+
+            std::error_code error;
+            std::filesystem::create_directories(m_directory, error);
+            if (error) GFX_WARN("Failed to create shader cache directory '{}': {}", m_directory.string(), error.message());
+        }
+    }
+
+    auto VulkanShaderCache::GetOrCompile(vk::ShaderStageFlagBits stage,
+                                         const std::string& source,
+                                         const std::string& sourcePath,
+                                         const std::vector<std::string>& defines) -> SharedPtr<const Entry>
+    {
+        auto cached = Find(stage, source, sourcePath, defines);
+        if (cached != nullptr) return cached;
+
+        const auto key = GetKey(stage, source, sourcePath, defines);
+
+        // Compile outside of the lock, so several shaders can be compiled at once
+        auto entry = CreateShared<Entry>();
+        if (LoadDependencies(key, entry->Dependencies) && AreDependenciesCurrent(entry->Dependencies))
+        {
+            entry->Spirv = LoadSpirv(key);
+        }
+
+        const bool compiled = entry->Spirv.empty();
+        if (compiled)
+        {
+            entry->Dependencies.clear();
+            entry->Spirv = Compile(stage, source, sourcePath, defines, entry->Dependencies);
+            if (entry->Spirv.empty()) return nullptr;
+
+            WriteFile(GetPath(key, "spv"), entry->Spirv.data(), entry->Spirv.size() * sizeof(uint32_t));
+            SaveDependencies(key, entry->Dependencies);
+        }
+
+        if (compiled || !LoadReflection(key, entry->Reflection))
+        {
+            entry->Reflection = VulkanShaderReflection::Reflect(stage, entry->Spirv);
+
+            const auto data = entry->Reflection.Serialize();
+            WriteFile(GetPath(key, "refl"), data.data(), data.size());
+        }
+
+        std::lock_guard lock(m_mutex);
+        return m_entries.try_emplace(key, std::move(entry)).first->second;
+    }
+
+    auto VulkanShaderCache::Find(vk::ShaderStageFlagBits stage,
+                                 const std::string& source,
+                                 const std::string& sourcePath,
+                                 const std::vector<std::string>& defines) -> SharedPtr<const Entry>
+    {
+        const auto key = GetKey(stage, source, sourcePath, defines);
+
+        std::lock_guard lock(m_mutex);
+        const auto it = m_entries.find(key);
+        return it != m_entries.end() ? it->second : nullptr;
+    }
+
+    auto VulkanShaderCache::GetInclude(const std::filesystem::path& path) -> SharedPtr<const Include>
+    {
+        const auto name = path.generic_string();
+
+        {
+            std::lock_guard lock(m_mutex);
+            const auto it = m_includes.find(name);
+            if (it != m_includes.end()) return it->second;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return nullptr;
+
+        std::stringstream stream;
+        stream << file.rdbuf();
+
+        auto include = CreateShared<Include>();
+        include->Content = stream.str();
+        include->Hash = HashString(include->Content);
+
+        std::lock_guard lock(m_mutex);
+        return m_includes.try_emplace(name, std::move(include)).first->second;
+    }
+
+    auto VulkanShaderCache::GetKey(vk::ShaderStageFlagBits stage,
+                                   const std::string& source,
+                                   const std::string& sourcePath,
+                                   const std::vector<std::string>& defines) const -> uint64_t
+    {
+        auto key = HashValue(stage, m_optionsHash);
+        key = HashString(sourcePath, key);
+        key = HashValue(defines.size(), key);
+        for (const auto& define : defines)
+        {
+            key = HashString(define, key);
+        }
+        return HashString(source, key);
+    }
+
+    auto VulkanShaderCache::Compile(vk::ShaderStageFlagBits stage,
+                                    const std::string& source,
+                                    const std::string& sourcePath,
+                                    const std::vector<std::string>& defines,
+                                    std::vector<Dependency>& dependencies) -> std::vector<uint32_t>
+    {
+        auto options = m_options;
+        for (const auto& define : defines)
+        {
+            options.AddMacroDefinition(define);
+        }
+        options.SetIncluder(CreateOwned<Utils::ShaderIncluder>(*this, std::filesystem::path(sourcePath).parent_path(), dependencies));
+
+        const auto* inputName = sourcePath.empty() ? "" : sourcePath.c_str();
+        const auto module = m_compiler.CompileGlslToSpv(source, Utils::VkShaderStageToShaderC(stage), inputName, options);
+        if (module.GetCompilationStatus() != shaderc_compilation_status_success)
+        {
+            GFX_ERROR("Shader Error | Stage = {} \n{}", vk::to_string(stage), module.GetErrorMessage());
+            return {};
+        }
+
+        return std::vector<uint32_t>(module.cbegin(), module.cend());
+    }
+
+    auto VulkanShaderCache::LoadSpirv(uint64_t key) const -> std::vector<uint32_t>
+    {
+        const auto path = GetPath(key, "spv");
+
+        const auto data = ReadFile(path);
+        if (data.empty()) return {};
+
+        if (data.size() % sizeof(uint32_t) != 0)
+        {
+            GFX_WARN("Discarding invalid cached shader '{}'!", path.string());
+            return {};
+        }
+
+        std::vector<uint32_t> spirv(data.size() / sizeof(uint32_t));
+        std::memcpy(spirv.data(), data.data(), data.size());
+        if (spirv[0] != Utils::SpirvMagic)
+        {
+            GFX_WARN("Discarding invalid cached shader '{}'!", path.string());
+            return {};
+        }
+
+        return spirv;
+    }
+
+    bool VulkanShaderCache::LoadReflection(uint64_t key, VulkanShaderReflection& reflection) const
+    {
+        const auto path = GetPath(key, "refl");
+
+        const auto data = ReadFile(path);
+        if (data.empty()) return false;
+
+        if (!VulkanShaderReflection::Deserialize(data, reflection))
+        {
+            GFX_WARN("Discarding invalid cached shader reflection '{}'!", path.string());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool VulkanShaderCache::LoadDependencies(uint64_t key, std::vector<Dependency>& dependencies) const
+    {
+        const auto path = GetPath(key, "deps");
+        if (path.empty()) return false;
+
+        std::ifstream file(path);
+        if (!file) return false;
+
+        // One "<hash> <path>" line per included file
+        std::string line;
+        while (std::getline(file, line))
+        {
+            const auto separator = line.find(' ');
+            if (separator == std::string::npos) return false;
+
+            auto& dependency = dependencies.emplace_back();
+            const auto result = std::from_chars(line.data(), line.data() + separator, dependency.Hash, 16);
+            if (result.ec != std::errc()) return false;
+
+            dependency.Path = line.substr(separator + 1);
+        }
+
+        return true;
+    }
+
+    void VulkanShaderCache::SaveDependencies(uint64_t key, const std::vector<Dependency>& dependencies) const
+    {
+        std::string data;
+        for (const auto& dependency : dependencies)
+        {
+            data += fmt::format("{:016x} {}\n", dependency.Hash, dependency.Path);
+        }
+
+        WriteFile(GetPath(key, "deps"), data.data(), data.size());
+    }
+
+    bool VulkanShaderCache::AreDependenciesCurrent(const std::vector<Dependency>& dependencies)
+    {
+        return std::all_of(dependencies.begin(),
+                           dependencies.end(),
+                           [this](const Dependency& dependency)
+                           {
+                               const auto include = GetInclude(dependency.Path);
+                               return include != nullptr && include->Hash == dependency.Hash;
+                           });
+    }
+
+    auto VulkanShaderCache::GetPath(uint64_t key, const char* extension) const -> std::filesystem::path
+    {
+        if (m_directory.empty()) return {};
+
+        return m_directory / fmt::format("{:016x}.{}", key, extension);
+    }
+
+    auto VulkanShaderCache::ReadFile(const std::filesystem::path& path) const -> std::vector<uint8_t>
+    {
+        if (path.empty()) return {};
+
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+        if (error || size == 0) return {};
+
+        std::vector<uint8_t> data(size);
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(data.data()), std::streamsize(size))) return {};
+
+        return data;
+    }
+
+    void VulkanShaderCache::WriteFile(const std::filesystem::path& path, const void* data, size_t size) const
+    {
+        if (path.empty()) return;
+
+        // Write to a temporary file first, so readers never see a partially written file
+        auto tempPath = path;
+        tempPath += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                GFX_WARN("Failed to write shader cache file '{}'!", tempPath.string());
+                return;
+            }
+
+            file.write(static_cast<const char*>(data), std::streamsize(size));
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error)
+        {
+            GFX_WARN("Failed to write shader cache file '{}': {}", path.string(), error.message());
+            std::filesystem::remove(tempPath, error);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+#include "VulkanShaderReflection.h"
+
+#include <vulkan/vulkan.hpp>
+#include <shaderc/shaderc.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx
+{
+    // Content addressed SPIR-V cache. Modules are keyed by a hash of their source, source path, defines, stage, target
+    // environment and compile options, kept in memory and, if a directory is given, stored on disk as `<key>.spv` together with their
+    // reflection as `<key>.refl` and the files they included as `<key>.deps`.
+    class VulkanShaderCache
+    {
+    public:
+        // A file pulled in through #include, with the hash of the content it was compiled against
+        struct Dependency
+        {
+            std::string Path;
+            uint64_t Hash = 0;
+        };
+
+        struct Entry
+        {
+            std::vector<uint32_t> Spirv;
+            VulkanShaderReflection Reflection;
+            std::vector<Dependency> Dependencies;
+        };
+
+        struct Include
+        {
+            std::string Content;
+            uint64_t Hash = 0;
+        };
+
+    public:
+        VulkanShaderCache(const std::string& directory);
+
+        // Returns the SPIR-V and reflection for `source`, only invoking shaderc and spirv-cross if neither memory nor
+        // disk has them, or one of the files it includes changed. `sourcePath` is the file the source was loaded from,
+        // relative includes are resolved against its directory. `defines` are passed to the preprocessor as empty macros.
+        // Returns nullptr if compilation failed.
+        auto GetOrCompile(vk::ShaderStageFlagBits stage,
+                          const std::string& source,
+                          const std::string& sourcePath = {},
+                          const std::vector<std::string>& defines = {}) -> SharedPtr<const Entry>;
+        // Only looks in memory, returns nullptr on a miss
+        auto Find(vk::ShaderStageFlagBits stage,
+                  const std::string& source,
+                  const std::string& sourcePath = {},
+                  const std::vector<std::string>& defines = {}) -> SharedPtr<const Entry>;
+
+        // Included files are read once and shared by every shader including them. Returns nullptr if the file cannot be read.
+        auto GetInclude(const std::filesystem::path& path) -> SharedPtr<const Include>;
+
+    private:
+        auto GetKey(vk::ShaderStageFlagBits stage, const std::string& source, const std::string& sourcePath, const std::vector<std::string>& defines) const
+            -> uint64_t;
+        auto Compile(vk::ShaderStageFlagBits stage,
+                     const std::string& source,
+                     const std::string& sourcePath,
+                     const std::vector<std::string>& defines,
+                     std::vector<Dependency>& dependencies) -> std::vector<uint32_t>;
+
+        auto LoadSpirv(uint64_t key) const -> std::vector<uint32_t>;
+        bool LoadReflection(uint64_t key, VulkanShaderReflection& reflection) const;
+        bool LoadDependencies(uint64_t key, std::vector<Dependency>& dependencies) const;
+        void SaveDependencies(uint64_t key, const std::vector<Dependency>& dependencies) const;
+        bool AreDependenciesCurrent(const std::vector<Dependency>& dependencies);
+
+        auto GetPath(uint64_t key, const char* extension) const -> std::filesystem::path;
+        auto ReadFile(const std::filesystem::path& path) const -> std::vector<uint8_t>;
+        void WriteFile(const std::filesystem::path& path, const void* data, size_t size) const;
+
+    private:
+        shaderc::Compiler m_compiler;
+        shaderc::CompileOptions m_options;
+        uint64_t m_optionsHash = 0;
+
+        std::filesystem::path m_directory;
+
+        std::mutex m_mutex;
+        std::unordered_map<uint64_t, SharedPtr<const Entry>> m_entries;
+        std::unordered_map<std::string, SharedPtr<const Include>> m_includes;
+    };
+}
@@ -0,0 +1,281 @@
+#include "VulkanShaderReflection.h"
+
+#include "GFX/Debug.h"
+#include "Utility/BinaryStream.h"
+
+#include <spirv_cross/spirv_glsl.hpp>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        constexpr uint32_t ReflectionMagic = 0x46525847;  // "GXRF"
+        constexpr uint32_t ReflectionVersion = 4;
+
+        auto ToShaderUniformType(const spirv_cross::SPIRType& type)
+        {
+            switch (type.basetype)
+            {
+                case spirv_cross::SPIRType::Boolean: return ShaderUniformType::eBool;
+                case spirv_cross::SPIRType::Int: return ShaderUniformType::eInt;
+                case spirv_cross::SPIRType::UInt: return ShaderUniformType::eUInt;
+                case spirv_cross::SPIRType::Float: if (type.vecsize == 1) return ShaderUniformType::eFloat;
+                    if (type.vecsize == 2) return ShaderUniformType::eVec2;
+                    if (type.vecsize == 3) return ShaderUniformType::eVec3;
+                    if (type.vecsize == 4) return ShaderUniformType::eVec4;
+
+                    if (type.columns == 3) return ShaderUniformType::eMat3;
+                    if (type.columns == 4) return ShaderUniformType::eMat4;
+                    break;
+            }
+            return ShaderUniformType::eNone;
+        }
+    }
+
+    auto VulkanShaderReflection::Reflect(vk::ShaderStageFlagBits stage, const std::vector<uint32_t>& spirv) -> VulkanShaderReflection
+    {
+        GFX_TRACE("===========================");
+        GFX_TRACE(" Vulkan Shader Reflection");
+        GFX_TRACE(" Stage: {}", vk::to_string(stage));
+        GFX_TRACE("===========================");
+
+        VulkanShaderReflection reflection{};
+
+        spirv_cross::Compiler compiler(spirv);
+        auto resources = compiler.get_shader_resources();
+
+        GFX_TRACE("Uniform Buffers");
+        for (const auto& resource : resources.uniform_buffers)
+        {
+            auto& bufferType = compiler.get_type(resource.base_type_id);
+
+            auto& uniformBuffer = reflection.UniformBuffers.emplace_back();
+            uniformBuffer.Name = resource.name;
+            uniformBuffer.Size = (uint32_t)compiler.get_declared_struct_size(bufferType);
+            uniformBuffer.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            uniformBuffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+
+            GFX_TRACE("  {} ({}, {})", uniformBuffer.Name, uniformBuffer.Set, uniformBuffer.Binding);
+            GFX_TRACE("    Member Count: {}", bufferType.member_types.size());
+            GFX_TRACE("    Size: {}", uniformBuffer.Size);
+        }
+
+        GFX_TRACE("Push Constant Buffers: ");
+        for (const auto& resource : resources.push_constant_buffers)
+        {
+            auto& bufferType = compiler.get_type(resource.base_type_id);
+            const auto memberCount = bufferType.member_types.size();
+
+            auto& buffer = reflection.PushConstantBuffers.emplace_back();
+            buffer.Name = resource.name;
+            buffer.Size = (uint32_t)compiler.get_declared_struct_size(bufferType);
+
+            GFX_TRACE("  Name: {}", buffer.Name);
+            GFX_TRACE("    Member Count: {}", memberCount);
+            GFX_TRACE("    Size: {}", buffer.Size);
+
+            for (uint32_t i = 0; i < memberCount; i++)
+            {
+                auto& member = buffer.Members.emplace_back();
+                member.Name = compiler.get_member_name(bufferType.self, i);
+                member.Type = Utils::ToShaderUniformType(compiler.get_type(bufferType.member_types[i]));
+                member.Size = (uint32_t)compiler.get_declared_struct_member_size(bufferType, i);
+                member.Offset = compiler.type_struct_member_offset(bufferType, i);
+            }
+        }
+
+        GFX_TRACE("Sampled Images: ");
+        for (const auto& resource : resources.sampled_images)
+        {
+            auto& type = compiler.get_type(resource.type_id);
+
+            auto& image = reflection.SampledImages.emplace_back();
+            image.Name = resource.name;
+            image.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            image.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            // Runtime sized arrays, e.g. `sampler2D Textures[]`, keep a size of 0, they index the bindless texture table
+            image.ArraySize = type.array.empty() ? 1 : type.array[0];
+
+            GFX_TRACE("  {}[{}] (set={}, binding={})", image.Name, image.ArraySize, image.Set, image.Binding);
+        }
+
+        GFX_TRACE("Storage Buffers: ");
+        for (const auto& resource : resources.storage_buffers)
+        {
+            auto& buffer = reflection.StorageBuffers.emplace_back();
+            buffer.Name = resource.name;
+            buffer.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            buffer.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+
+            GFX_TRACE("  {} (set={}, binding={})", buffer.Name, buffer.Set, buffer.Binding);
+        }
+
+        GFX_TRACE("Storage Images: ");
+        for (const auto& resource : resources.storage_images)
+        {
+            auto& type = compiler.get_type(resource.type_id);
+
+            auto& image = reflection.StorageImages.emplace_back();
+            image.Name = resource.name;
+            image.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+            image.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+            image.ArraySize = type.array.empty() || type.array[0] == 0 ? 1 : type.array[0];
+
+            GFX_TRACE("  {}[{}] (set={}, binding={})", image.Name, image.ArraySize, image.Set, image.Binding);
+        }
+
+        GFX_TRACE("Specialization Constants: ");
+        for (const auto& constant : compiler.get_specialization_constants())
+        {
+            const auto& value = compiler.get_constant(constant.id);
+
+            auto& specializationConstant = reflection.SpecializationConstants.emplace_back();
+            specializationConstant.Name = compiler.get_name(constant.id);
+            specializationConstant.ConstantID = constant.constant_id;
+            specializationConstant.Type = Utils::ToShaderUniformType(compiler.get_type(value.constant_type));
+
+            GFX_TRACE("  {} (constant_id={})", specializationConstant.Name, specializationConstant.ConstantID);
+        }
+
+        GFX_TRACE("===========================");
+
+        return reflection;
+    }
+
+    auto VulkanShaderReflection::Serialize() const -> std::vector<uint8_t>
+    {
+        BinaryWriter writer;
+        writer.Write(Utils::ReflectionMagic);
+        writer.Write(Utils::ReflectionVersion);
+
+        writer.Write(uint32_t(UniformBuffers.size()));
+        for (const auto& uniformBuffer : UniformBuffers)
+        {
+            writer.Write(uniformBuffer.Name);
+            writer.Write(uniformBuffer.Set);
+            writer.Write(uniformBuffer.Binding);
+            writer.Write(uniformBuffer.Size);
+        }
+
+        writer.Write(uint32_t(PushConstantBuffers.size()));
+        for (const auto& buffer : PushConstantBuffers)
+        {
+            writer.Write(buffer.Name);
+            writer.Write(buffer.Size);
+            writer.Write(uint32_t(buffer.Members.size()));
+            for (const auto& member : buffer.Members)
+            {
+                writer.Write(member.Name);
+                writer.Write(uint32_t(member.Type));
+                writer.Write(member.Size);
+                writer.Write(member.Offset);
+            }
+        }
+
+        writer.Write(uint32_t(SampledImages.size()));
+        for (const auto& image : SampledImages)
+        {
+            writer.Write(image.Name);
+            writer.Write(image.Set);
+            writer.Write(image.Binding);
+            writer.Write(image.ArraySize);
+        }
+
+        writer.Write(uint32_t(StorageBuffers.size()));
+        for (const auto& buffer : StorageBuffers)
+        {
+            writer.Write(buffer.Name);
+            writer.Write(buffer.Set);
+            writer.Write(buffer.Binding);
+        }
+
+        writer.Write(uint32_t(StorageImages.size()));
+        for (const auto& image : StorageImages)
+        {
+            writer.Write(image.Name);
+            writer.Write(image.Set);
+            writer.Write(image.Binding);
+            writer.Write(image.ArraySize);
+        }
+
+        writer.Write(uint32_t(SpecializationConstants.size()));
+        for (const auto& constant : SpecializationConstants)
+        {
+            writer.Write(constant.Name);
+            writer.Write(constant.ConstantID);
+            writer.Write(uint32_t(constant.Type));
+        }
+
+        return std::move(writer.GetData());
+    }
+
+    bool VulkanShaderReflection::Deserialize(const std::vector<uint8_t>& data, VulkanShaderReflection& reflection)
+    {
+        BinaryReader reader(data);
+
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        if (!reader.Read(magic) || !reader.Read(version)) return false;
+        if (magic != Utils::ReflectionMagic || version != Utils::ReflectionVersion) return false;
+
+        reflection = {};
+
+        uint32_t count = 0;
+        if (!reader.Read(count)) return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& uniformBuffer = reflection.UniformBuffers.emplace_back();
+            if (!reader.Read(uniformBuffer.Name) || !reader.Read(uniformBuffer.Set) || !reader.Read(uniformBuffer.Binding) ||
+                !reader.Read(uniformBuffer.Size))
+                return false;
+        }
+
+        if (!reader.Read(count)) return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& buffer = reflection.PushConstantBuffers.emplace_back();
+            uint32_t memberCount = 0;
+            if (!reader.Read(buffer.Name) || !reader.Read(buffer.Size) || !reader.Read(memberCount)) return false;
+
+            for (uint32_t j = 0; j < memberCount; j++)
+            {
+                auto& member = buffer.Members.emplace_back();
+                uint32_t type = 0;
+                if (!reader.Read(member.Name) || !reader.Read(type) || !reader.Read(member.Size) || !reader.Read(member.Offset)) return false;
+                member.Type = ShaderUniformType(type);
+            }
+        }
+
+        if (!reader.Read(count)) return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& image = reflection.SampledImages.emplace_back();
+            if (!reader.Read(image.Name) || !reader.Read(image.Set) || !reader.Read(image.Binding) || !reader.Read(image.ArraySize)) return false;
+        }
+
+        if (!reader.Read(count)) return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& buffer = reflection.StorageBuffers.emplace_back();
+            if (!reader.Read(buffer.Name) || !reader.Read(buffer.Set) || !reader.Read(buffer.Binding)) return false;
+        }
+
+        if (!reader.Read(count)) return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& image = reflection.StorageImages.emplace_back();
+            if (!reader.Read(image.Name) || !reader.Read(image.Set) || !reader.Read(image.Binding) || !reader.Read(image.ArraySize)) return false;
+        }
+
+        if (!reader.Read(count)) return false;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& constant = reflection.SpecializationConstants.emplace_back();
+            uint32_t type = 0;
+            if (!reader.Read(constant.Name) || !reader.Read(constant.ConstantID) || !reader.Read(type)) return false;
+            constant.Type = ShaderUniformType(type);
+        }
+
+        return reader.IsAtEnd();
+    }
+}
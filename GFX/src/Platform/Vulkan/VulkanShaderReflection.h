@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GFX/Resources/Shader.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+    // Everything VulkanShader needs to know about one stage's resources, extracted with spirv-cross once and
+    // serialized next to the cached SPIR-V so later runs can skip reflection.
+    struct VulkanShaderReflection
+    {
+        struct UniformBuffer
+        {
+            std::string Name;
+            uint32_t Set = 0;
+            uint32_t Binding = 0;
+            uint32_t Size = 0;
+        };
+
+        struct PushConstantMember
+        {
+            std::string Name;
+            ShaderUniformType Type = ShaderUniformType::eNone;
+            uint32_t Size = 0;
+            uint32_t Offset = 0;  // Relative to the start of the push constant block
+        };
+
+        struct PushConstantBuffer
+        {
+            std::string Name;
+            uint32_t Size = 0;
+            std::vector<PushConstantMember> Members;
+        };
+
+        struct SampledImage
+        {
+            std::string Name;
+            uint32_t Set = 0;
+            uint32_t Binding = 0;
+            uint32_t ArraySize = 0;  // 0 for runtime sized arrays
+        };
+
+        struct StorageBuffer
+        {
+            std::string Name;
+            uint32_t Set = 0;
+            uint32_t Binding = 0;
+        };
+
+        struct StorageImage
+        {
+            std::string Name;
+            uint32_t Set = 0;
+            uint32_t Binding = 0;
+            uint32_t ArraySize = 0;
+        };
+
+        struct SpecializationConstant
+        {
+            std::string Name;
+            uint32_t ConstantID = 0;
+            ShaderUniformType Type = ShaderUniformType::eNone;
+        };
+
+        std::vector<UniformBuffer> UniformBuffers;
+        std::vector<PushConstantBuffer> PushConstantBuffers;
+        std::vector<SampledImage> SampledImages;
+        std::vector<StorageBuffer> StorageBuffers;
+        std::vector<StorageImage> StorageImages;
+        std::vector<SpecializationConstant> SpecializationConstants;
+
+        static auto Reflect(vk::ShaderStageFlagBits stage, const std::vector<uint32_t>& spirv) -> VulkanShaderReflection;
+
+        auto Serialize() const -> std::vector<uint8_t>;
+        // Returns false if `data` is truncated or was written by an incompatible version
+        static bool Deserialize(const std::vector<uint8_t>& data, VulkanShaderReflection& reflection);
+    };
+}
@@ -0,0 +1,220 @@
+#include "VulkanStagingRing.h"
+
+#include "GFX/Debug.h"
+
+#include "VulkanDevice.h"
+#include "VulkanAllocator.h"
+#include "VulkanUtils.h"
+
+namespace gfx
+{
+    /* Vulkan Submission */
+
+    VulkanSubmission::VulkanSubmission(VulkanDevice& device)
+        : m_device(device)
+    {
+    }
+
+    VulkanSubmission::~VulkanSubmission()
+    {
+        if (!m_fence) return;
+
+        Wait();
+        m_device.GetHandle().destroy(m_fence);
+        m_device.GetHandle().destroy(m_semaphore);
+
+        const auto lock = m_device.LockCommandPools();
+        for (const auto& [commandPool, cmdBuffer] : m_cmdBuffers)
+            m_device.GetHandle().free(commandPool, cmdBuffer);
+    }
+
+    void VulkanSubmission::Submit(vk::Queue queue, vk::CommandPool commandPool, vk::CommandBuffer cmdBuffer)
+    {
+        GFX_ASSERT(!IsSubmitted(), "Submission has already been submitted!");
+
+        End(commandPool, cmdBuffer);
+
+        vk::FenceCreateInfo fenceInfo{};
+        m_fence = m_device.GetHandle().createFence(fenceInfo);
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.setCommandBuffers(cmdBuffer);
+
+        m_device.Submit(queue, submitInfo, m_fence);
+    }
+
+    void VulkanSubmission::Submit(vk::Queue queue,
+                                  vk::CommandPool commandPool,
+                                  vk::CommandBuffer cmdBuffer,
+                                  vk::Queue acquireQueue,
+                                  vk::CommandPool acquireCommandPool,
+                                  vk::CommandBuffer acquireCmdBuffer)
+    {
+        GFX_ASSERT(!IsSubmitted(), "Submission has already been submitted!");
+
+        End(commandPool, cmdBuffer);
+        End(acquireCommandPool, acquireCmdBuffer);
+
+        vk::SemaphoreCreateInfo semaphoreInfo{};
+        m_semaphore = m_device.GetHandle().createSemaphore(semaphoreInfo);
+
+        vk::FenceCreateInfo fenceInfo{};
+        m_fence = m_device.GetHandle().createFence(fenceInfo);
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.setCommandBuffers(cmdBuffer);
+        submitInfo.setSignalSemaphores(m_semaphore);
+
+        m_device.Submit(queue, submitInfo);
+
+        const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+
+        vk::SubmitInfo acquireSubmitInfo{};
+        acquireSubmitInfo.setCommandBuffers(acquireCmdBuffer);
+        acquireSubmitInfo.setWaitSemaphores(m_semaphore);
+        acquireSubmitInfo.setWaitDstStageMask(waitStage);
+
+        // The second submission can only complete after the first one, so a single fence covers both
+        m_device.Submit(acquireQueue, acquireSubmitInfo, m_fence);
+    }
+
+    void VulkanSubmission::Retain(OwnedPtr<Buffer>&& buffer) { m_retainedBuffers.push_back(std::move(buffer)); }
+
+    bool VulkanSubmission::IsComplete() const
+    {
+        return IsSubmitted() && m_device.GetHandle().getFenceStatus(m_fence) == vk::Result::eSuccess;
+    }
+
+    void VulkanSubmission::Wait() const
+    {
+        if (!IsSubmitted()) return;
+
+        void(m_device.GetHandle().waitForFences(m_fence, true, UINT64_MAX));
+    }
+
+    void VulkanSubmission::End(vk::CommandPool commandPool, vk::CommandBuffer cmdBuffer)
+    {
+        cmdBuffer.end();
+        m_cmdBuffers.emplace_back(commandPool, cmdBuffer);
+    }
+
+    /* Vulkan Staging Ring */
+
+    VulkanStagingRing::VulkanStagingRing(VulkanDevice& device, VulkanAllocator& allocator, const vk::DeviceSize size)
+        : m_device(device),
+          m_allocator(allocator),
+          m_size(size)
+    {
+        vk::BufferCreateInfo bufferInfo{};
+        bufferInfo.setSize(m_size);
+        bufferInfo.setUsage(vk::BufferUsageFlagBits::eTransferSrc);
+
+        void* mapped = nullptr;
+        m_allocator.Allocate(bufferInfo, VMA_MEMORY_USAGE_CPU_ONLY, &m_buffer, &m_allocation, &mapped);
+        m_mapped = static_cast<uint8_t*>(mapped);
+        GFX_ASSERT(m_mapped != nullptr, "Failed to map staging ring!");
+    }
+
+    VulkanStagingRing::~VulkanStagingRing()
+    {
+        m_device.WaitIdle();
+        m_regions.clear();
+
+        m_allocator.Free(m_buffer, m_allocation);
+    }
+
+    bool VulkanStagingRing::Allocate(const vk::DeviceSize size,
+                                     const vk::DeviceSize alignment,
+                                     const SharedPtr<VulkanSubmission>& submission,
+                                     Allocation& outAllocation)
+    {
+        // Requests this large would have to wait for the whole ring and then some
+        if (size >= m_size) return false;
+
+        std::lock_guard lock(m_mutex);
+
+        vk::DeviceSize offset = 0;
+        while (!TryAllocate(size, alignment, offset))
+        {
+            // Out of space, block on the oldest region still in flight
+            if (m_regions.empty()) return false;
+
+            const auto& oldest = m_regions.front().Submission;
+            if (!oldest->IsSubmitted()) return false;
+
+            oldest->Wait();
+            RetireCompleted();
+        }
+
+        m_regions.push_back({ m_head, submission });
+
+        outAllocation.Buffer = m_buffer;
+        outAllocation.Offset = offset;
+        outAllocation.Mapped = m_mapped + offset;
+        return true;
+    }
+
+    void VulkanStagingRing::Track(const SharedPtr<VulkanSubmission>& submission)
+    {
+        std::lock_guard lock(m_mutex);
+
+        // An empty region ending at the head, which releases nothing when it is retired
+        m_regions.push_back({ m_head, submission });
+    }
+
+    void VulkanStagingRing::Retire()
+    {
+        std::lock_guard lock(m_mutex);
+        RetireCompleted();
+    }
+
+    bool VulkanStagingRing::TryAllocate(const vk::DeviceSize size, const vk::DeviceSize alignment, vk::DeviceSize& outOffset)
+    {
+        // The head never catches up with the tail, so head == tail always means the ring is empty
+        if (m_head >= m_tail)
+        {
+            // Free space is [head, size) followed by [0, tail)
+            const auto offset = VkUtils::AlignUp(m_head, alignment);
+            if (offset + size <= m_size)
+            {
+                outOffset = offset;
+                m_head = offset + size;
+                return true;
+            }
+            if (size < m_tail)
+            {
+                // Wrap around, the skipped bytes are released together with the preceding region
+                outOffset = 0;
+                m_head = size;
+                return true;
+            }
+            return false;
+        }
+
+        // Free space is [head, tail)
+        const auto offset = VkUtils::AlignUp(m_head, alignment);
+        if (offset + size < m_tail)
+        {
+            outOffset = offset;
+            m_head = offset + size;
+            return true;
+        }
+        return false;
+    }
+
+    void VulkanStagingRing::RetireCompleted()
+    {
+        // Regions are released in allocation order, which is also their order within the ring
+        while (!m_regions.empty() && m_regions.front().Submission->IsComplete())
+        {
+            m_tail = m_regions.front().End;
+            m_regions.pop_front();
+        }
+
+        if (m_regions.empty())
+        {
+            m_head = 0;
+            m_tail = 0;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "GFX/Core/Base.h"
+#include "GFX/Resources/Buffer.h"
+#include "GFX/Resources/UploadBatch.h"
+#include "vk_mem_alloc.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace gfx
+{
+    class VulkanDevice;
+    class VulkanAllocator;
+
+    // Command buffers submitted to a queue, together with the fence that signals their completion
+    class VulkanSubmission : public UploadFence
+    {
+    public:
+        VulkanSubmission(VulkanDevice& device);
+        ~VulkanSubmission() override;
+
+        // Command buffers are allocated from the device's pools, the caller holds VulkanDevice::LockCommandPools() from
+        // allocating them until they are submitted. Freeing them once complete takes the lock itself.
+        void Submit(vk::Queue queue, vk::CommandPool commandPool, vk::CommandBuffer cmdBuffer);
+
+        // Submits `cmdBuffer`, then `acquireCmdBuffer` on a second queue once the first has finished executing
+        void Submit(vk::Queue queue,
+                    vk::CommandPool commandPool,
+                    vk::CommandBuffer cmdBuffer,
+                    vk::Queue acquireQueue,
+                    vk::CommandPool acquireCommandPool,
+                    vk::CommandBuffer acquireCmdBuffer);
+
+        // Keeps `buffer` alive until the submission has completed
+        void Retain(OwnedPtr<Buffer>&& buffer);
+
+        bool IsSubmitted() const { return bool(m_fence); }
+        bool IsComplete() const override;
+        void Wait() const override;
+
+    private:
+        void End(vk::CommandPool commandPool, vk::CommandBuffer cmdBuffer);
+
+    private:
+        VulkanDevice& m_device;
+
+        std::vector<std::pair<vk::CommandPool, vk::CommandBuffer>> m_cmdBuffers;
+        vk::Semaphore m_semaphore;
+        vk::Fence m_fence;
+
+        std::vector<OwnedPtr<Buffer>> m_retainedBuffers;
+    };
+
+    class VulkanStagingRing
+    {
+    public:
+        struct Allocation
+        {
+            vk::Buffer Buffer;
+            vk::DeviceSize Offset = 0;
+            void* Mapped = nullptr;
+        };
+
+        VulkanStagingRing(VulkanDevice& device, VulkanAllocator& allocator, vk::DeviceSize size);
+        ~VulkanStagingRing();
+
+        auto GetSize() const -> vk::DeviceSize { return m_size; }
+
+        // Reserves staging memory until `submission` has completed. Blocks on older submissions when the ring is full,
+        // returns false if the space is held by copies which have not been submitted yet.
+        bool Allocate(vk::DeviceSize size, vk::DeviceSize alignment, const SharedPtr<VulkanSubmission>& submission, Allocation& outAllocation);
+
+        // Holds on to `submission` until it has completed, without reserving any memory for it
+        void Track(const SharedPtr<VulkanSubmission>& submission);
+
+        // Releases the memory of all submissions which have completed
+        void Retire();
+
+    private:
+        struct Region
+        {
+            vk::DeviceSize End = 0;
+            SharedPtr<VulkanSubmission> Submission;
+        };
+
+        bool TryAllocate(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& outOffset);
+        void RetireCompleted();
+
+    private:
+        VulkanDevice& m_device;
+        VulkanAllocator& m_allocator;
+
+        vk::DeviceSize m_size;
+        vk::Buffer m_buffer;
+        VmaAllocation m_allocation{};
+        uint8_t* m_mapped = nullptr;
+
+        vk::DeviceSize m_head = 0;
+        vk::DeviceSize m_tail = 0;
+        std::deque<Region> m_regions;
+
+        std::mutex m_mutex;
+    };
+}
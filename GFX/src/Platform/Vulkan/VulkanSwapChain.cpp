@@ -79,6 +79,9 @@ namespace gfx
 
         CreateFrameResources();
 
+        const auto uniformAlignment = gpu.GetProperties().limits.minUniformBufferOffsetAlignment;
+        m_transientUniforms = CreateOwned<TransientUniformAllocator>(Config::TransientUniformSize, uniformAlignment, Config::FramesInFlight);
+
         Recreate(m_window->GetWidth(), m_window->GetHeight());
     }
 
@@ -156,6 +159,13 @@ namespace gfx
 
         // Vulkan::ResetDescriptorPool(GetFrameIndex());
         device.ResetDescriptorPool(m_frameIndex);
+        // Persistent sets freed while this frame was recorded can be reused
+        device.GetDescriptorAllocator().NewFrame(m_frameIndex);
+
+        // The GPU is done with this frame's transient uniforms
+        m_transientUniforms->Reset(m_frameIndex);
+        // and with the bindless texture indices released while it was recorded
+        backend->GetTextureTable().NewFrame(m_frameIndex);
 
         // Request image from swapchain
         m_imageIndex = device.AcquireNextImage(m_swapChain, frame.PresentComplete);
@@ -170,6 +180,8 @@ namespace gfx
         auto cmdBufferHandle = vkCmdBuffer->GetHandle();
         std::vector<vk::PipelineStageFlags> waitStages = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
 
+        m_transientUniforms->Flush();
+
         vk::SubmitInfo submitInfo{};
         submitInfo.setCommandBuffers(cmdBufferHandle);
         submitInfo.setWaitSemaphores(GetCurrentFrame().PresentComplete);
@@ -177,14 +189,14 @@ namespace gfx
         submitInfo.setWaitDstStageMask(waitStages);
 
         GetCurrentFrame().RenderFence = vkCmdBuffer->GetFence();
-        device.GetGraphicsQueue().submit(submitInfo, GetCurrentFrame().RenderFence);
+        device.Submit(device.GetGraphicsQueue(), submitInfo, GetCurrentFrame().RenderFence);
 
         vk::PresentInfoKHR presentInfo{};
         presentInfo.setSwapchains(m_swapChain);
         presentInfo.setImageIndices(m_imageIndex);
         presentInfo.setWaitSemaphores(GetCurrentFrame().RenderComplete);
 
-        void(device.GetGraphicsQueue().presentKHR(presentInfo));
+        device.Present(presentInfo);
 
         m_frameIndex = (m_frameIndex + 1) % Config::FramesInFlight;
     }
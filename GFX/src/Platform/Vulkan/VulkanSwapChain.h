@@ -1,6 +1,7 @@
 #include "GFX/Core/SwapChain.h"
 
 #include "GFX/Config.h"
+#include "GFX/Resources/UniformBuffer.h"
 #include "vk_mem_alloc.h"
 
 #include <vulkan/vulkan.hpp>
@@ -22,6 +23,8 @@ namespace gfx
 
         auto GetFrameIndex() const -> uint32_t override { return m_frameIndex; }
 
+        auto GetTransientUniforms() -> TransientUniformAllocator& override { return *m_transientUniforms; }
+
         auto GetRenderPass() const -> vk::RenderPass { return m_renderPass; }
 
         auto GetCurrentFramebuffer() const -> vk::Framebuffer { return m_framebuffers.at(m_imageIndex); }
@@ -74,5 +77,7 @@ namespace gfx
 
         std::array<Frame, Config::FramesInFlight> m_frames = {};
         uint32_t m_frameIndex = 0;
+
+        OwnedPtr<TransientUniformAllocator> m_transientUniforms;
     };
 }
@@ -4,42 +4,59 @@
 
 #include "VulkanBackend.h"
 #include "VulkanAllocator.h"
-#include "VulkanBuffer.h"
+#include "VulkanUploadBatch.h"
 #include "VulkanUtils.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace gfx
 {
-    VulkanTexture::VulkanTexture(const TextureImporter& importer)
+    VulkanTexture::VulkanTexture(const TextureImporter& importer, const SamplerDesc& sampler, UploadBatch* batch)
     {
         TextureDesc desc{};
         desc.Width = importer.GetWidth();
         desc.Height = importer.GetHeight();
         desc.Format = importer.GetFormat();
         desc.Usage = TextureUsage::eTexture;
+        desc.Mips = 0;
+        desc.Sampler = sampler;
         Init(desc);
 
-        SetData(importer.GetData());
+        SetData(importer.GetData(), batch);
     }
 
-    VulkanTexture::VulkanTexture(const TextureBuilder& builder)
+    VulkanTexture::VulkanTexture(const TextureBuilder& builder, const SamplerDesc& sampler, UploadBatch* batch)
     {
         TextureDesc desc{};
         desc.Width = builder.GetWidth();
         desc.Height = builder.GetHeight();
         desc.Format = builder.GetFormat();
         desc.Usage = TextureUsage::eTexture;
+        desc.Mips = 0;
+        desc.Sampler = sampler;
         Init(desc);
 
-        SetData(builder.GetData());
+        SetData(builder.GetData(), batch);
     }
 
-    VulkanTexture::VulkanTexture(const TextureDesc& desc, const std::vector<uint8_t>& data)
+    VulkanTexture::VulkanTexture(const TextureDesc& desc, const std::vector<uint8_t>& data, UploadBatch* batch)
     {
         Init(desc);
 
-        if(!data.empty())
+        if (desc.Usage == TextureUsage::eStorage)
         {
-            SetData(data);
+            GFX_ASSERT(data.empty(), "Storage textures are written by compute shaders and cannot be created with data!");
+
+            auto& device = VulkanBackend::Get()->GetDevice();
+            const auto lock = device.LockCommandPools();
+            auto cmdBuffer = device.GetCommandBuffer(true);
+            TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+            device.FlushCommandBuffer(cmdBuffer);
+        }
+        else if(!data.empty())
+        {
+            SetData(data, batch);
         }
     }
 
@@ -49,19 +66,31 @@ namespace gfx
         auto& allocator = backend->GetAllocator();
         auto vkDevice = backend->GetDevice().GetHandle();
 
-        vkDevice.destroy(m_sampler);
+        backend->GetTextureTable().Release(m_bindlessIndex);
+
         vkDevice.destroy(m_view);
 
         allocator.Free(m_image, m_allocation);
         GFX_TRACE("Vulkan texture released.");
     }
 
+    auto VulkanTexture::GetBindlessIndex() -> uint32_t
+    {
+        if (m_bindlessIndex == VulkanTextureTable::InvalidIndex)
+        {
+            m_bindlessIndex = VulkanBackend::Get()->GetTextureTable().Register(*this);
+        }
+        return m_bindlessIndex;
+    }
+
     auto VulkanTexture::GetImageInfo() const -> vk::DescriptorImageInfo
     {
         vk::DescriptorImageInfo info{};
         info.setImageView(m_view);
         info.setSampler(m_sampler);
-        if (GetFormat() == TextureFormat::eDepth24Stencil8 || GetFormat() == TextureFormat::eDepth32f)
+        if (m_usage == TextureUsage::eStorage)
+            info.setImageLayout(vk::ImageLayout::eGeneral);
+        else if (GetFormat() == TextureFormat::eDepth24Stencil8 || GetFormat() == TextureFormat::eDepth32f)
             info.setImageLayout(vk::ImageLayout::eDepthStencilReadOnlyOptimal);
         else
             info.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
@@ -74,13 +103,31 @@ namespace gfx
         m_width = desc.Width;
         m_height = desc.Height;
         m_format = desc.Format;
+        m_usage = desc.Usage;
+        m_samplerDesc = desc.Sampler;
+        m_mips = desc.Mips == 0 ? CalculateMipCount(m_width, m_height) : std::min(desc.Mips, CalculateMipCount(m_width, m_height));
+        GFX_ASSERT(m_mips == 1 || desc.Usage == TextureUsage::eTexture, "Only sampled textures can have mips!");
 
         auto* backend = VulkanBackend::Get();
         auto& allocator = backend->GetAllocator();
         auto vkDevice = backend->GetDevice().GetHandle();
 
+        GFX_ASSERT(!IsCompressedFormat(m_format) || backend->GetPhysicalDevice().GetFeatures().textureCompressionBC,
+                   "Block compressed textures are not supported by the device!");
+
         const bool isDepthFormat = IsDepthFormat(desc.Format);
         const auto usage = VkUtils::ToVkTextureUsage(desc.Usage, isDepthFormat);
+
+        // Levels are blitted from the one before them, which needs linear filtering of the format
+        const auto formatProperties = backend->GetPhysicalDevice().GetHandle().getFormatProperties(VkUtils::ToVkTextureFormat(desc.Format));
+        const auto formatFeatures = formatProperties.optimalTilingFeatures;
+        const auto blitFeatures =
+            vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+        m_blitMips = (formatFeatures & blitFeatures) == blitFeatures;
+
+        // sRGB formats such as eRGBA are almost never usable as storage images, see TextureUsage::eStorage
+        GFX_ASSERT(desc.Usage != TextureUsage::eStorage || (formatFeatures & vk::FormatFeatureFlagBits::eStorageImage),
+                   "Texture format cannot be used as a storage image on this device, use eRGBA16f instead!");
         vk::ImageAspectFlags aspectMask = isDepthFormat ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
         if (desc.Format == TextureFormat::eDepth24Stencil8) aspectMask |= vk::ImageAspectFlagBits::eStencil;
 
@@ -90,7 +137,7 @@ namespace gfx
         imageInfo.extent.setWidth(m_width);
         imageInfo.extent.setHeight(m_height);
         imageInfo.extent.setDepth(1);
-        imageInfo.setMipLevels(1);
+        imageInfo.setMipLevels(m_mips);
         imageInfo.setArrayLayers(1);
         imageInfo.setUsage(usage);
         imageInfo.setInitialLayout(vk::ImageLayout::eUndefined);
@@ -105,62 +152,155 @@ namespace gfx
         viewInfo.setViewType(vk::ImageViewType::e2D);
         viewInfo.subresourceRange.setAspectMask(aspectMask);
         viewInfo.subresourceRange.setBaseMipLevel(0);
-        viewInfo.subresourceRange.setLevelCount(1);
+        viewInfo.subresourceRange.setLevelCount(m_mips);
         viewInfo.subresourceRange.setLayerCount(1);
         viewInfo.subresourceRange.setBaseArrayLayer(0);
 
         m_view = vkDevice.createImageView(viewInfo);
 
-        vk::SamplerCreateInfo samplerInfo{};
-        samplerInfo.setAddressModeU(vk::SamplerAddressMode::eRepeat);
-        samplerInfo.setAddressModeV(vk::SamplerAddressMode::eRepeat);
-        samplerInfo.setAddressModeW(vk::SamplerAddressMode::eRepeat);
-        // samplerInfo.borderColor = vk::BorderColor::
-        samplerInfo.setMagFilter(vk::Filter::eLinear);
-        samplerInfo.setMinFilter(vk::Filter::eLinear);
+        m_sampler = backend->GetSamplerCache().GetSampler(desc.Sampler);
+    }
 
-        m_sampler = vkDevice.createSampler(samplerInfo);
+    auto VulkanTexture::GetUploadMipCount(const size_t size) const -> uint32_t
+    {
+        uint32_t mips = 0;
+        while (mips < m_mips && CalculateTextureSize(m_width, m_height, m_format, mips + 1) <= size) mips++;
+        return mips;
     }
 
-    void VulkanTexture::SetData(const std::vector<uint8_t>& data) const
+    void VulkanTexture::RecordUpload(vk::CommandBuffer cmdBuffer,
+                                     vk::Buffer stagingBuffer,
+                                     const vk::DeviceSize stagingOffset,
+                                     const uint32_t mips,
+                                     const uint32_t srcQueueFamily,
+                                     const uint32_t dstQueueFamily) const
     {
-        auto* backend = VulkanBackend::Get();
+        // Only the uploaded levels, the others are first used on the queue generating them
+        TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, 0, mips);
 
-        const auto stagingBuffer = Buffer::CreateStaging(data.size(), data.data());
-        auto* vkStagingBuffer = static_cast<VulkanBuffer*>(stagingBuffer.get());
+        std::vector<vk::BufferImageCopy> copyRegions(mips);
+        for (uint32_t mip = 0; mip < mips; mip++)
+        {
+            auto& copyRegion = copyRegions[mip];
+            copyRegion.setBufferOffset(stagingOffset + CalculateTextureSize(m_width, m_height, m_format, mip));
+            copyRegion.setBufferRowLength(0);
+            copyRegion.setBufferImageHeight(0);
+            copyRegion.imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
+            copyRegion.imageSubresource.setMipLevel(mip);
+            copyRegion.imageSubresource.setBaseArrayLayer(0);
+            copyRegion.imageSubresource.setLayerCount(1);
+            copyRegion.imageOffset = vk::Offset3D(0, 0, 0);
+            copyRegion.imageExtent = vk::Extent3D(std::max(m_width >> mip, 1u), std::max(m_height >> mip, 1u), 1);
+        }
 
-        auto& device = backend->GetDevice();
-        auto cmdBuffer = device.GetCommandBuffer(true);
+        cmdBuffer.copyBufferToImage(stagingBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, copyRegions);
 
-        TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+        if (srcQueueFamily == dstQueueFamily)
+        {
+            if (mips < m_mips)
+                RecordGenerateMips(cmdBuffer, mips);
+            else
+                TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+            return;
+        }
 
-        vk::BufferImageCopy copyRegion{};
-        copyRegion.setBufferOffset(0);
-        copyRegion.setBufferRowLength(0);
-        copyRegion.setBufferImageHeight(0);
-        copyRegion.imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
-        copyRegion.imageSubresource.setMipLevel(0);
-        copyRegion.imageSubresource.setBaseArrayLayer(0);
-        copyRegion.imageSubresource.setLayerCount(1);
-        copyRegion.imageOffset = vk::Offset3D(0, 0, 0);
-        copyRegion.imageExtent = vk::Extent3D(m_width, m_height, 1);
+        // Release ownership, the matching acquire is recorded by RecordAcquire()
+        auto barrier = GetOwnershipBarrier(srcQueueFamily, dstQueueFamily, mips);
+        barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
 
-        cmdBuffer.copyBufferToImage(vkStagingBuffer->GetHandle(), m_image, vk::ImageLayout::eTransferDstOptimal, copyRegion);
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, barrier);
+    }
 
-        TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+    void VulkanTexture::RecordAcquire(vk::CommandBuffer cmdBuffer, const uint32_t mips, const uint32_t srcQueueFamily, const uint32_t dstQueueFamily) const
+    {
+        auto barrier = GetOwnershipBarrier(srcQueueFamily, dstQueueFamily, mips);
+        if (mips < m_mips)
+        {
+            // Blits need a graphics queue, so the missing levels are generated after the hand over
+            barrier.setDstAccessMask(vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite);
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, barrier);
 
-        device.FlushCommandBuffer(cmdBuffer);
+            RecordGenerateMips(cmdBuffer, mips);
+            return;
+        }
+
+        barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+        cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, barrier);
     }
 
-    void VulkanTexture::TransitionImageLayout(vk::CommandBuffer& cmdBuffer, vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const
+    void VulkanTexture::RecordGenerateMips(vk::CommandBuffer cmdBuffer, const uint32_t firstMip) const
+    {
+        GFX_ASSERT(firstMip > 0 && m_blitMips, "Mips are blitted from the uploaded levels!");
+
+        // Uploaded levels before the one the first blit reads from are done
+        if (firstMip > 1)
+            TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, 0, firstMip - 1);
+        TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, firstMip, m_mips - firstMip);
+
+        for (uint32_t mip = firstMip; mip < m_mips; mip++)
+        {
+            TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal, mip - 1, 1);
+
+            vk::ImageBlit blit{};
+            blit.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, mip - 1, 0, 1);
+            blit.srcOffsets[1] = vk::Offset3D(int32_t(std::max(m_width >> (mip - 1), 1u)), int32_t(std::max(m_height >> (mip - 1), 1u)), 1);
+            blit.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, mip, 0, 1);
+            blit.dstOffsets[1] = vk::Offset3D(int32_t(std::max(m_width >> mip, 1u)), int32_t(std::max(m_height >> mip, 1u)), 1);
+
+            cmdBuffer.blitImage(m_image, vk::ImageLayout::eTransferSrcOptimal, m_image, vk::ImageLayout::eTransferDstOptimal, blit, vk::Filter::eLinear);
+
+            TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, mip - 1, 1);
+        }
+
+        TransitionImageLayout(cmdBuffer, m_image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, m_mips - 1, 1);
+    }
+
+    void VulkanTexture::SetData(const std::vector<uint8_t>& data, UploadBatch* batch)
+    {
+        if (batch != nullptr)
+        {
+            batch->Upload(this, data);
+            return;
+        }
+
+        VulkanUploadBatch ownBatch;
+        ownBatch.Upload(this, data);
+        ownBatch.Flush();
+    }
+
+    auto VulkanTexture::GetOwnershipBarrier(const uint32_t srcQueueFamily, const uint32_t dstQueueFamily, const uint32_t mips) const
+        -> vk::ImageMemoryBarrier
+    {
+        // Levels which still have to be generated stay transfer destinations, the first blit reads from them
+        vk::ImageMemoryBarrier barrier{};
+        barrier.setImage(m_image);
+        barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+        barrier.setNewLayout(mips < m_mips ? vk::ImageLayout::eTransferDstOptimal : vk::ImageLayout::eShaderReadOnlyOptimal);
+        barrier.setSrcQueueFamilyIndex(srcQueueFamily);
+        barrier.setDstQueueFamilyIndex(dstQueueFamily);
+        barrier.subresourceRange.setAspectMask(vk::ImageAspectFlagBits::eColor);
+        barrier.subresourceRange.setBaseMipLevel(0);
+        barrier.subresourceRange.setLevelCount(mips);
+        barrier.subresourceRange.setBaseArrayLayer(0);
+        barrier.subresourceRange.setLayerCount(1);
+        return barrier;
+    }
+
+    void VulkanTexture::TransitionImageLayout(vk::CommandBuffer cmdBuffer,
+                                              vk::Image image,
+                                              vk::ImageLayout oldLayout,
+                                              vk::ImageLayout newLayout,
+                                              const uint32_t baseMip,
+                                              const uint32_t mipCount) const
     {
         vk::ImageMemoryBarrier barrier{};
         barrier.setImage(image);
         barrier.setOldLayout(oldLayout);
         barrier.setNewLayout(newLayout);
         barrier.subresourceRange.setAspectMask(vk::ImageAspectFlagBits::eColor);
-        barrier.subresourceRange.setBaseMipLevel(0);
-        barrier.subresourceRange.setLevelCount(1);
+        barrier.subresourceRange.setBaseMipLevel(baseMip);
+        barrier.subresourceRange.setLevelCount(mipCount);
         barrier.subresourceRange.setBaseArrayLayer(0);
         barrier.subresourceRange.setLayerCount(1);
 
@@ -182,6 +322,30 @@ namespace gfx
             srcStage = vk::PipelineStageFlagBits::eTransfer;
             dstStage = vk::PipelineStageFlagBits::eFragmentShader;
         }
+        else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eTransferSrcOptimal)
+        {
+            barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+            barrier.setDstAccessMask(vk::AccessFlagBits::eTransferRead);
+
+            srcStage = vk::PipelineStageFlagBits::eTransfer;
+            dstStage = vk::PipelineStageFlagBits::eTransfer;
+        }
+        else if (oldLayout == vk::ImageLayout::eTransferSrcOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal)
+        {
+            barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferRead);
+            barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+            srcStage = vk::PipelineStageFlagBits::eTransfer;
+            dstStage = vk::PipelineStageFlagBits::eFragmentShader;
+        }
+        else if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eGeneral)
+        {
+            barrier.setSrcAccessMask({});
+            barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+
+            srcStage = vk::PipelineStageFlagBits::eTopOfPipe;
+            dstStage = vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eFragmentShader;
+        }
         else
         {
             GFX_ERROR("Unsupported layout transition!");
@@ -10,14 +10,18 @@ namespace gfx
     class VulkanTexture : public Texture
     {
     public:
-        VulkanTexture(const TextureImporter& importer);
-        VulkanTexture(const TextureBuilder& builder);
-        VulkanTexture(const TextureDesc& desc, const std::vector<uint8_t>& data = {});
+        VulkanTexture(const TextureImporter& importer, const SamplerDesc& sampler = {}, UploadBatch* batch = nullptr);
+        VulkanTexture(const TextureBuilder& builder, const SamplerDesc& sampler = {}, UploadBatch* batch = nullptr);
+        VulkanTexture(const TextureDesc& desc, const std::vector<uint8_t>& data = {}, UploadBatch* batch = nullptr);
         ~VulkanTexture() override;
 
         auto GetWidth() const -> uint32_t override { return m_width; }
         auto GetHeight() const -> uint32_t override { return m_height; }
         auto GetFormat() const -> TextureFormat override { return m_format; }
+        auto GetMipCount() const -> uint32_t override { return m_mips; }
+        auto GetSamplerDesc() const -> const SamplerDesc& override { return m_samplerDesc; }
+
+        auto GetBindlessIndex() -> uint32_t override;
 
         auto GetHandle() const -> vk::Image { return m_image; }
         auto GetView() const -> vk::ImageView { return m_view; }
@@ -25,21 +29,53 @@ namespace gfx
 
         auto GetImageInfo() const -> vk::DescriptorImageInfo;
 
+        // Levels fully contained in `size` bytes of tightly packed texture data
+        auto GetUploadMipCount(size_t size) const -> uint32_t;
+        // Whether the levels missing from an upload can be blitted on the GPU, otherwise they have to be uploaded too
+        bool CanBlitMips() const { return m_blitMips; }
+
+        // Records the copy of the first `mips` levels of staged pixel data into the image, including the required layout
+        // transitions, and blits the levels after them. When the queue families differ ownership is released to
+        // `dstQueueFamily` and has to be acquired with RecordAcquire(), which then records the blits on that queue.
+        void RecordUpload(vk::CommandBuffer cmdBuffer,
+                          vk::Buffer stagingBuffer,
+                          vk::DeviceSize stagingOffset,
+                          uint32_t mips,
+                          uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED,
+                          uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED) const;
+        void RecordAcquire(vk::CommandBuffer cmdBuffer, uint32_t mips, uint32_t srcQueueFamily, uint32_t dstQueueFamily) const;
+
     private:
         void Init(const TextureDesc& desc);
-        void SetData(const std::vector<uint8_t>& data) const;
+        // Records the upload into `batch`, or uploads right away through a batch of its own if there is none
+        void SetData(const std::vector<uint8_t>& data, UploadBatch* batch);
 
-        void TransitionImageLayout(vk::CommandBuffer& cmdBuffer, vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const;
+        // Expects levels [0, `firstMip`) in the transfer destination layout, leaves every level ready to be sampled
+        void RecordGenerateMips(vk::CommandBuffer cmdBuffer, uint32_t firstMip) const;
+
+        auto GetOwnershipBarrier(uint32_t srcQueueFamily, uint32_t dstQueueFamily, uint32_t mips) const -> vk::ImageMemoryBarrier;
+        void TransitionImageLayout(vk::CommandBuffer cmdBuffer,
+                                   vk::Image image,
+                                   vk::ImageLayout oldLayout,
+                                   vk::ImageLayout newLayout,
+                                   uint32_t baseMip = 0,
+                                   uint32_t mipCount = VK_REMAINING_MIP_LEVELS) const;
 
     private:
         vk::Image m_image{};
         VmaAllocation m_allocation{};
         vk::ImageView m_view{};
 
-        vk::Sampler m_sampler{};
+        vk::Sampler m_sampler{};  // Owned by the sampler cache
+        SamplerDesc m_samplerDesc{};
 
         uint32_t m_width = 0;
         uint32_t m_height = 0;
+        uint32_t m_mips = 1;
+        bool m_blitMips = false;
         TextureFormat m_format{};
+        TextureUsage m_usage{};
+
+        uint32_t m_bindlessIndex = UINT32_MAX;  // Registered with the texture table on first use
     };
 }
@@ -0,0 +1,135 @@
+#include "VulkanTextureTable.h"
+
+#include "GFX/Debug.h"
+#include "VulkanDevice.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanTexture.h"
+
+#include <algorithm>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        bool IsTextureTableSupported(const vk::PhysicalDeviceVulkan12Features& features)
+        {
+            return features.runtimeDescriptorArray && features.shaderSampledImageArrayNonUniformIndexing && features.descriptorBindingPartiallyBound &&
+                   features.descriptorBindingSampledImageUpdateAfterBind && features.descriptorBindingUpdateUnusedWhilePending;
+        }
+    }
+
+    VulkanTextureTable::VulkanTextureTable(VulkanDevice& device, VulkanPhysicalDevice& physicalDevice)
+        : m_device(device.GetHandle())
+    {
+        if (!Utils::IsTextureTableSupported(physicalDevice.GetFeatures12()))
+        {
+            GFX_WARN("Descriptor indexing is not supported, bindless textures are unavailable.");
+            return;
+        }
+
+        const auto& properties12 = physicalDevice.GetProperties12();
+        m_capacity = std::min({ Config::MaxBindlessTextures,
+                                properties12.maxDescriptorSetUpdateAfterBindSampledImages,
+                                properties12.maxDescriptorSetUpdateAfterBindSamplers,
+                                properties12.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                properties12.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+        vk::DescriptorSetLayoutBinding binding{};
+        binding.setBinding(0);
+        binding.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
+        binding.setDescriptorCount(m_capacity);
+        binding.setStageFlags(vk::ShaderStageFlagBits::eAll);
+
+        // Only registered textures are valid, and registering never touches indices pending frames may sample
+        const vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                        vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.setBindingFlags(bindingFlags);
+
+        vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool);
+        layoutInfo.setBindings(binding);
+        layoutInfo.setPNext(&bindingFlagsInfo);
+
+        // Not interned, no other layout has these flags
+        auto layout = CreateShared<VulkanDescriptorSetLayout>();
+        layout->Handle = m_device.createDescriptorSetLayout(layoutInfo);
+        layout->PoolSizes = { vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, m_capacity) };
+        m_layout = layout;
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind);
+        poolInfo.setPoolSizes(m_layout->PoolSizes);
+        poolInfo.setMaxSets(1);
+        m_pool = m_device.createDescriptorPool(poolInfo);
+
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.setDescriptorPool(m_pool);
+        allocInfo.setDescriptorSetCount(1);
+        allocInfo.setSetLayouts(m_layout->Handle);
+        m_set = m_device.allocateDescriptorSets(allocInfo)[0];
+
+        GFX_INFO("Created bindless texture table for {} textures.", m_capacity);
+    }
+
+    VulkanTextureTable::~VulkanTextureTable()
+    {
+        if (m_pool) m_device.destroy(m_pool);
+    }
+
+    auto VulkanTextureTable::Register(const VulkanTexture& texture) -> uint32_t
+    {
+        GFX_ASSERT(IsSupported(), "Bindless textures are not supported!");
+
+        std::lock_guard lock(m_mutex);
+
+        uint32_t index = InvalidIndex;
+        if (!m_freeIndices.empty())
+        {
+            index = m_freeIndices.back();
+            m_freeIndices.pop_back();
+        }
+        else if (m_nextIndex < m_capacity)
+        {
+            index = m_nextIndex++;
+        }
+        else
+        {
+            GFX_ERROR("Bindless texture table is full ({} textures)!", m_capacity);
+            return InvalidIndex;
+        }
+
+        const auto imageInfo = texture.GetImageInfo();
+
+        vk::WriteDescriptorSet write{};
+        write.setDstSet(m_set);
+        write.setDstBinding(0);
+        write.setDstArrayElement(index);
+        write.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
+        write.setImageInfo(imageInfo);
+
+        // Writes to the set have to be externally synchronised, so this stays under the lock
+        m_device.updateDescriptorSets(write, {});
+        return index;
+    }
+
+    void VulkanTextureTable::Release(uint32_t index)
+    {
+        if (index == InvalidIndex) return;
+
+        std::lock_guard lock(m_mutex);
+        m_releasedIndices[m_frameIndex].push_back(index);
+    }
+
+    void VulkanTextureTable::NewFrame(uint32_t frameIndex)
+    {
+        std::lock_guard lock(m_mutex);
+
+        // The last frame which used this index has finished, so has every frame before it which released an index
+        auto& released = m_releasedIndices[frameIndex];
+        m_freeIndices.insert(m_freeIndices.end(), released.begin(), released.end());
+        released.clear();
+
+        m_frameIndex = frameIndex;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GFX/Config.h"
+#include "VulkanLayoutCache.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace gfx
+{
+    class VulkanDevice;
+    class VulkanPhysicalDevice;
+    class VulkanTexture;
+
+    // Global descriptor set of every texture registered through Texture::GetBindlessIndex(). Shaders declare it as a runtime
+    // sized array alone in its set, e.g. `layout(set = 2, binding = 0) uniform sampler2D Textures[];`, and index it with
+    // indices passed through push constants or instance data. Command buffers bind it with the first pipeline using it,
+    // after that it stays bound across compatible pipelines.
+    class VulkanTextureTable
+    {
+    public:
+        static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+        VulkanTextureTable(VulkanDevice& device, VulkanPhysicalDevice& physicalDevice);
+        ~VulkanTextureTable();
+
+        // Requires descriptor indexing with update after bind for sampled images
+        bool IsSupported() const { return bool(m_set); }
+
+        auto GetLayout() const -> const SharedPtr<const VulkanDescriptorSetLayout>& { return m_layout; }
+        auto GetHandle() const -> vk::DescriptorSet { return m_set; }
+        auto GetCapacity() const -> uint32_t { return m_capacity; }
+
+        auto Register(const VulkanTexture& texture) -> uint32_t;
+        // The index is handed out again once every frame in flight which could still sample it has finished
+        void Release(uint32_t index);
+
+        // Called when the frame `frameIndex` starts, after waiting for the GPU to finish its previous use
+        void NewFrame(uint32_t frameIndex);
+
+    private:
+        vk::Device m_device;
+
+        SharedPtr<const VulkanDescriptorSetLayout> m_layout;
+        vk::DescriptorPool m_pool;
+        vk::DescriptorSet m_set;
+        uint32_t m_capacity = 0;
+
+        std::mutex m_mutex;
+        uint32_t m_nextIndex = 0;
+        std::vector<uint32_t> m_freeIndices;
+        std::array<std::vector<uint32_t>, Config::FramesInFlight> m_releasedIndices;  // Per frame they were released in
+        uint32_t m_frameIndex = 0;
+    };
+}
@@ -0,0 +1,239 @@
+#include "VulkanUploadBatch.h"
+
+#include "GFX/Debug.h"
+#include "GFX/Resources/MipGenerator.h"
+
+#include "VulkanBackend.h"
+#include "VulkanBuffer.h"
+#include "VulkanTexture.h"
+
+#include <cstring>
+
+namespace gfx
+{
+    // Satisfies buffer-to-image copy alignment for every texel size we support
+    constexpr vk::DeviceSize StagingAlignment = 16;
+
+    constexpr auto BufferReadAccess = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead | vk::AccessFlagBits::eUniformRead |
+                                      vk::AccessFlagBits::eIndirectCommandRead;
+    constexpr auto BufferReadStages = vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput |
+                                      vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+
+    VulkanUploadBatch::VulkanUploadBatch() { Reset(); }
+
+    VulkanUploadBatch::~VulkanUploadBatch() { Flush(); }
+
+    void VulkanUploadBatch::Upload(Buffer* buffer, const size_t offset, const size_t size, const void* data)
+    {
+        if (size == 0) return;
+
+        auto* vkBuffer = static_cast<VulkanBuffer*>(buffer);
+        GFX_ASSERT(offset + size <= vkBuffer->GetSize(), "Upload exceeds buffer size!");
+
+        if (vkBuffer->IsHostVisible())
+        {
+            // No staging required
+            vkBuffer->SetData(offset, size, data);
+            return;
+        }
+
+        const auto staging = Stage(size, data);
+
+        auto& copy = m_bufferCopies.emplace_back();
+        copy.Src = staging.Buffer;
+        copy.Dst = vkBuffer->GetHandle();
+        copy.Region.setSrcOffset(staging.Offset);
+        copy.Region.setDstOffset(offset);
+        copy.Region.setSize(size);
+    }
+
+    void VulkanUploadBatch::Upload(Texture* texture, const std::vector<uint8_t>& data)
+    {
+        if (data.empty()) return;
+
+        auto* vkTexture = static_cast<VulkanTexture*>(texture);
+        const auto mips = vkTexture->GetUploadMipCount(data.size());
+        GFX_ASSERT(mips > 0, "Texture data is smaller than its first level!");
+
+        if (mips < vkTexture->GetMipCount() && !vkTexture->CanBlitMips())
+        {
+            GFX_ASSERT(!IsCompressedFormat(vkTexture->GetFormat()), "Block compressed textures need every level uploaded, see CompressTexture()!");
+
+            // The format cannot be blitted, so the missing levels are generated on the CPU from the first one instead
+            const auto chain =
+                GenerateMips(data, vkTexture->GetWidth(), vkTexture->GetHeight(), vkTexture->GetFormat(), MipFilter::eBox, vkTexture->GetMipCount());
+            Upload(texture, chain);
+            return;
+        }
+
+        const auto staging = Stage(CalculateTextureSize(vkTexture->GetWidth(), vkTexture->GetHeight(), vkTexture->GetFormat(), mips), data.data());
+
+        auto& copy = m_textureCopies.emplace_back();
+        copy.Src = staging.Buffer;
+        copy.SrcOffset = staging.Offset;
+        copy.Texture = vkTexture;
+        copy.Mips = mips;
+    }
+
+    void VulkanUploadBatch::Flush()
+    {
+        const auto fence = Submit();
+        if (fence != nullptr) fence->Wait();
+    }
+
+    auto VulkanUploadBatch::Submit() -> SharedPtr<UploadFence>
+    {
+        if (!HasPendingCopies()) return nullptr;
+
+        auto* backend = VulkanBackend::Get();
+        auto& device = backend->GetDevice();
+        auto& ring = backend->GetStagingRing();
+
+        ring.Retire();
+
+        const auto& queueFamilyIndices = backend->GetPhysicalDevice().GetQueueFamilyIndices();
+        const auto transferFamily = uint32_t(queueFamilyIndices.Transfer);
+        const auto graphicsFamily = uint32_t(queueFamilyIndices.Graphics);
+
+        {
+            // Batches are submitted from any thread, the device's command pools are shared between them
+            const auto lock = device.LockCommandPools();
+            auto transferCmdBuffer = device.GetTransferCommandBuffer(true);
+
+            if (transferFamily == graphicsFamily)
+            {
+                RecordCopies(transferCmdBuffer, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
+                m_submission->Submit(device.GetTransferQueue(), device.GetTransferCommandPool(), transferCmdBuffer);
+            }
+            else
+            {
+                // Exclusive resources written on the transfer queue have to be handed over to the graphics queue
+                RecordCopies(transferCmdBuffer, transferFamily, graphicsFamily);
+
+                auto acquireCmdBuffer = device.GetCommandBuffer(true);
+                RecordAcquire(acquireCmdBuffer, transferFamily, graphicsFamily);
+
+                m_submission->Submit(device.GetTransferQueue(),
+                                     device.GetTransferCommandPool(),
+                                     transferCmdBuffer,
+                                     device.GetGraphicsQueue(),
+                                     device.GetCommandPool(),
+                                     acquireCmdBuffer);
+            }
+        }
+
+        // Keep the submission alive until it completes, even if the caller drops the fence
+        ring.Track(m_submission);
+
+        SharedPtr<UploadFence> fence = m_submission;
+        Reset();
+        return fence;
+    }
+
+    auto VulkanUploadBatch::Stage(const size_t size, const void* data) -> VulkanStagingRing::Allocation
+    {
+        auto& ring = VulkanBackend::Get()->GetStagingRing();
+
+        VulkanStagingRing::Allocation allocation{};
+        bool allocated = ring.Allocate(size, StagingAlignment, m_submission, allocation);
+        if (!allocated && HasPendingCopies())
+        {
+            // The ring is full of our own copies, send them off and try again
+            Submit();
+            allocated = ring.Allocate(size, StagingAlignment, m_submission, allocation);
+        }
+
+        if (!allocated)
+        {
+            // Uploads which do not fit into the staging ring get their own staging buffer
+            auto stagingBuffer = Buffer::CreateStaging(size, data);
+            allocation.Buffer = static_cast<VulkanBuffer*>(stagingBuffer.get())->GetHandle();
+            allocation.Offset = 0;
+            m_submission->Retain(std::move(stagingBuffer));
+            return allocation;
+        }
+
+        std::memcpy(allocation.Mapped, data, size);
+        return allocation;
+    }
+
+    void VulkanUploadBatch::RecordCopies(vk::CommandBuffer cmdBuffer, const uint32_t srcQueueFamily, const uint32_t dstQueueFamily) const
+    {
+        for (const auto& copy : m_bufferCopies)
+        {
+            cmdBuffer.copyBuffer(copy.Src, copy.Dst, copy.Region);
+        }
+
+        if (!m_bufferCopies.empty())
+        {
+            if (srcQueueFamily == dstQueueFamily)
+            {
+                // One barrier makes every buffer copy visible to the stages that read vertex, index, uniform and indirect data
+                vk::MemoryBarrier barrier{};
+                barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+                barrier.setDstAccessMask(BufferReadAccess);
+
+                cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, BufferReadStages, {}, barrier, {}, {});
+            }
+            else
+            {
+                // Release ownership, the matching acquire is recorded by RecordAcquire()
+                std::vector<vk::BufferMemoryBarrier> barriers;
+                barriers.reserve(m_bufferCopies.size());
+                for (const auto& copy : m_bufferCopies)
+                {
+                    auto& barrier = barriers.emplace_back();
+                    barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+                    barrier.setSrcQueueFamilyIndex(srcQueueFamily);
+                    barrier.setDstQueueFamilyIndex(dstQueueFamily);
+                    barrier.setBuffer(copy.Dst);
+                    barrier.setOffset(copy.Region.dstOffset);
+                    barrier.setSize(copy.Region.size);
+                }
+
+                cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, barriers, {});
+            }
+        }
+
+        for (const auto& copy : m_textureCopies)
+        {
+            copy.Texture->RecordUpload(cmdBuffer, copy.Src, copy.SrcOffset, copy.Mips, srcQueueFamily, dstQueueFamily);
+        }
+    }
+
+    void VulkanUploadBatch::RecordAcquire(vk::CommandBuffer cmdBuffer, const uint32_t srcQueueFamily, const uint32_t dstQueueFamily) const
+    {
+        if (!m_bufferCopies.empty())
+        {
+            std::vector<vk::BufferMemoryBarrier> barriers;
+            barriers.reserve(m_bufferCopies.size());
+            for (const auto& copy : m_bufferCopies)
+            {
+                auto& barrier = barriers.emplace_back();
+                barrier.setDstAccessMask(BufferReadAccess);
+                barrier.setSrcQueueFamilyIndex(srcQueueFamily);
+                barrier.setDstQueueFamilyIndex(dstQueueFamily);
+                barrier.setBuffer(copy.Dst);
+                barrier.setOffset(copy.Region.dstOffset);
+                barrier.setSize(copy.Region.size);
+            }
+
+            cmdBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, BufferReadStages, {}, {}, barriers, {});
+        }
+
+        for (const auto& copy : m_textureCopies)
+        {
+            copy.Texture->RecordAcquire(cmdBuffer, copy.Mips, srcQueueFamily, dstQueueFamily);
+        }
+    }
+
+    void VulkanUploadBatch::Reset()
+    {
+        auto& device = VulkanBackend::Get()->GetDevice();
+
+        m_bufferCopies.clear();
+        m_textureCopies.clear();
+
+        m_submission = CreateShared<VulkanSubmission>(device);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "GFX/Resources/UploadBatch.h"
+#include "VulkanStagingRing.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace gfx
+{
+    class VulkanTexture;
+
+    class VulkanUploadBatch : public UploadBatch
+    {
+    public:
+        VulkanUploadBatch();
+        ~VulkanUploadBatch() override;
+
+        void Upload(Buffer* buffer, size_t offset, size_t size, const void* data) override;
+        void Upload(Texture* texture, const std::vector<uint8_t>& data) override;
+
+        void Flush() override;
+        auto Submit() -> SharedPtr<UploadFence> override;
+
+    private:
+        struct BufferCopy
+        {
+            vk::Buffer Src;
+            vk::Buffer Dst;
+            vk::BufferCopy Region;
+        };
+
+        struct TextureCopy
+        {
+            vk::Buffer Src;
+            vk::DeviceSize SrcOffset = 0;
+            VulkanTexture* Texture = nullptr;
+            uint32_t Mips = 0;  // Levels in the staged data
+        };
+
+        bool HasPendingCopies() const { return !m_bufferCopies.empty() || !m_textureCopies.empty(); }
+
+        auto Stage(size_t size, const void* data) -> VulkanStagingRing::Allocation;
+        void RecordCopies(vk::CommandBuffer cmdBuffer, uint32_t srcQueueFamily, uint32_t dstQueueFamily) const;
+        void RecordAcquire(vk::CommandBuffer cmdBuffer, uint32_t srcQueueFamily, uint32_t dstQueueFamily) const;
+        void Reset();
+
+    private:
+        std::vector<BufferCopy> m_bufferCopies;
+        std::vector<TextureCopy> m_textureCopies;
+
+        SharedPtr<VulkanSubmission> m_submission;
+    };
+}
@@ -10,7 +10,7 @@ namespace gfx
         {
             default: break;
             case vk::SamplerAddressMode::eRepeat: return WrapMode::eRepeat;
-            case vk::SamplerAddressMode::eMirrorClampToEdge: return WrapMode::eMirror;
+            case vk::SamplerAddressMode::eMirroredRepeat: return WrapMode::eMirror;
             case vk::SamplerAddressMode::eClampToEdge: return WrapMode::eClamp;
             case vk::SamplerAddressMode::eClampToBorder: return WrapMode::eBorder;
         }
@@ -23,19 +23,47 @@ namespace gfx
         {
             default: break;
             case WrapMode::eRepeat: return vk::SamplerAddressMode::eRepeat;
-            case WrapMode::eMirror: return vk::SamplerAddressMode::eMirrorClampToEdge;
+            case WrapMode::eMirror: return vk::SamplerAddressMode::eMirroredRepeat;
             case WrapMode::eClamp: return vk::SamplerAddressMode::eClampToEdge;
             case WrapMode::eBorder: return vk::SamplerAddressMode::eClampToBorder;
         }
         return {};
     }
 
+    auto VkUtils::ToVkFilter(const FilterMode mode) -> vk::Filter
+    {
+        switch (mode)
+        {
+            default: break;
+            case FilterMode::eNearest: return vk::Filter::eNearest;
+            case FilterMode::eLinear: return vk::Filter::eLinear;
+        }
+        return {};
+    }
+
+    auto VkUtils::ToVkMipmapMode(const FilterMode mode) -> vk::SamplerMipmapMode
+    {
+        switch (mode)
+        {
+            default: break;
+            case FilterMode::eNearest: return vk::SamplerMipmapMode::eNearest;
+            case FilterMode::eLinear: return vk::SamplerMipmapMode::eLinear;
+        }
+        return {};
+    }
+
     auto VkUtils::ToTextureFormat(const vk::Format format) -> TextureFormat
     {
         switch (format)
         {
             default: break;
             case vk::Format::eR8G8B8A8Srgb: return TextureFormat::eRGBA;
+            case vk::Format::eR16G16B16A16Sfloat: return TextureFormat::eRGBA16f;
+            case vk::Format::eBc1RgbSrgbBlock: return TextureFormat::eBC1;
+            case vk::Format::eBc3SrgbBlock: return TextureFormat::eBC3;
+            case vk::Format::eBc4UnormBlock: return TextureFormat::eBC4;
+            case vk::Format::eBc5UnormBlock: return TextureFormat::eBC5;
+            case vk::Format::eBc7SrgbBlock: return TextureFormat::eBC7;
         }
         return {};
     }
@@ -48,8 +76,14 @@ namespace gfx
             default: break;
             case TextureFormat::eR: return vk::Format::eR8Unorm;
             case TextureFormat::eRGBA: return vk::Format::eR8G8B8A8Srgb;
+            case TextureFormat::eRGBA16f: return vk::Format::eR16G16B16A16Sfloat;
             case TextureFormat::eDepth32f: return vk::Format::eD32Sfloat;
             case TextureFormat::eDepth24Stencil8: return vk::Format::eD24UnormS8Uint;
+            case TextureFormat::eBC1: return vk::Format::eBc1RgbSrgbBlock;
+            case TextureFormat::eBC3: return vk::Format::eBc3SrgbBlock;
+            case TextureFormat::eBC4: return vk::Format::eBc4UnormBlock;
+            case TextureFormat::eBC5: return vk::Format::eBc5UnormBlock;
+            case TextureFormat::eBC7: return vk::Format::eBc7SrgbBlock;
         }
         return {};
     }
@@ -75,6 +109,10 @@ namespace gfx
         {
             imageUsage |= vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
         }
+        else if (usage == TextureUsage::eStorage)
+        {
+            imageUsage |= vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
+        }
         return imageUsage;
     }
 
@@ -84,6 +122,8 @@ namespace gfx
             return ShaderStage::eVertex;
         if (stage == vk::ShaderStageFlagBits::eFragment)
             return ShaderStage::ePixel;
+        if (stage == vk::ShaderStageFlagBits::eCompute)
+            return ShaderStage::eCompute;
 
         return ShaderStage::eNone;
     }
@@ -94,9 +134,16 @@ namespace gfx
         {
             case ShaderStage::eVertex: return vk::ShaderStageFlagBits::eVertex;
             case ShaderStage::ePixel: return vk::ShaderStageFlagBits::eFragment;
+            case ShaderStage::eCompute: return vk::ShaderStageFlagBits::eCompute;
             case ShaderStage::eNone:
             default: break;
         }
         return {};
     }
+
+    auto VkUtils::AlignUp(const vk::DeviceSize value, const vk::DeviceSize alignment) -> vk::DeviceSize
+    {
+        if (alignment == 0) return value;
+        return (value + alignment - 1) / alignment * alignment;
+    }
 }
@@ -12,6 +12,8 @@ namespace gfx
     {
         auto ToWrapMode(vk::SamplerAddressMode mode) -> WrapMode;
         auto ToVkWrapMode(WrapMode mode) -> vk::SamplerAddressMode;
+        auto ToVkFilter(FilterMode mode) -> vk::Filter;
+        auto ToVkMipmapMode(FilterMode mode) -> vk::SamplerMipmapMode;
 
         auto ToTextureFormat(vk::Format format) -> TextureFormat;
         auto ToVkTextureFormat(TextureFormat format) -> vk::Format;
@@ -21,5 +23,7 @@ namespace gfx
 
         auto ToShaderStage(vk::ShaderStageFlagBits stage) -> ShaderStage;
         auto ToVkShaderStage(ShaderStage stage) -> vk::ShaderStageFlags;
+
+        auto AlignUp(vk::DeviceSize value, vk::DeviceSize alignment) -> vk::DeviceSize;
     }
 }
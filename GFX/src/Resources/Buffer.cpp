@@ -36,4 +36,14 @@ namespace gfx
     {
         return Create(BufferUsage::eUniform, size, data);
     }
+
+    auto Buffer::CreateIndirect(uint64_t size, const void* data, bool forceLocalMemory) -> OwnedPtr<Buffer>
+    {
+        return Create(BufferUsage::eIndirect, size, data, forceLocalMemory);
+    }
+
+    auto Buffer::CreateStorage(uint64_t size, const void* data, bool forceLocalMemory) -> OwnedPtr<Buffer>
+    {
+        return Create(BufferUsage::eStorage, size, data, forceLocalMemory);
+    }
 }
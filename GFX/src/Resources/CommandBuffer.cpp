@@ -3,6 +3,7 @@
 #include "GFX/Core/GFXCore.h"
 #include "GFX/Core/Backend.h"
 
+#include "Platform/Vulkan/VulkanBackend.h"
 #include "Platform/Vulkan/VulkanCommandBuffer.h"
 
 namespace gfx
@@ -18,4 +19,40 @@ namespace gfx
         }
         return nullptr;
     }
+
+    auto CommandBuffer::CreateSecondary(uint32_t count) -> OwnedPtr<CommandBuffer>
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return CreateOwned<VulkanCommandBuffer>(count, true);
+            case BackendType::eNone:
+            default: break;
+        }
+        return nullptr;
+    }
+
+    bool CommandBuffer::IsDrawIndirectFirstInstanceSupported()
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return VulkanBackend::Get()->GetPhysicalDevice().GetFeatures().drawIndirectFirstInstance;
+            case BackendType::eNone:
+            default: break;
+        }
+        return false;
+    }
+
+    bool CommandBuffer::IsDrawIndirectCountSupported()
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return VulkanBackend::Get()->GetPhysicalDevice().GetFeatures12().drawIndirectCount;
+            case BackendType::eNone:
+            default: break;
+        }
+        return false;
+    }
 }
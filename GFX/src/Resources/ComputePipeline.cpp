@@ -0,0 +1,19 @@
+#include "GFX/Resources/ComputePipeline.h"
+
+#include "GFX/Core/GFXCore.h"
+#include "Platform/Vulkan/VulkanComputePipeline.h"
+
+namespace gfx
+{
+    auto ComputePipeline::Create(const ComputePipelineDesc& desc) -> OwnedPtr<ComputePipeline>
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return CreateOwned<VulkanComputePipeline>(desc);
+            case BackendType::eNone:
+            default: break;
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,135 @@
+#include "GFX/Resources/GeometryPool.h"
+
+#include "GFX/Debug.h"
+#include "GFX/Resources/Buffer.h"
+#include "GFX/Resources/MeshBuilder.h"
+#include "GFX/Resources/MeshImporter.h"
+#include "GFX/Resources/UploadBatch.h"
+#include "Utility/FreeListAllocator.h"
+
+namespace gfx
+{
+    auto GeometryPool::Create(const uint32_t vertexCapacity, const uint32_t indexCapacity) -> OwnedPtr<GeometryPool>
+    {
+        return CreateOwned<GeometryPool>(vertexCapacity, indexCapacity);
+    }
+
+    GeometryPool::GeometryPool(const uint32_t vertexCapacity, const uint32_t indexCapacity)
+    {
+        m_vertexBuffer = Buffer::CreateVertex(sizeof(Vertex) * vertexCapacity);
+        m_indexBuffer = Buffer::CreateIndex(sizeof(uint32_t) * indexCapacity);
+
+        m_vertexAllocator = CreateOwned<FreeListAllocator>(vertexCapacity);
+        m_indexAllocator = CreateOwned<FreeListAllocator>(indexCapacity);
+    }
+
+    GeometryPool::~GeometryPool() = default;
+
+    auto GeometryPool::Allocate(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, UploadBatch* batch) -> Mesh
+    {
+        Mesh mesh{};
+        {
+            std::lock_guard lock(m_mutex);
+
+            // Empty ranges, e.g. the indices of non-indexed geometry, take no space and cannot run out of it
+            const auto baseVertex = vertices.empty() ? 0 : m_vertexAllocator->Allocate((uint32_t)vertices.size());
+            if (baseVertex == FreeListAllocator::InvalidOffset)
+            {
+                GFX_ERROR("GeometryPool: Out of vertex space! Requested = {}, Free = {}", vertices.size(), m_vertexAllocator->GetFreeSpace());
+                return {};
+            }
+
+            const auto firstIndex = indices.empty() ? 0 : m_indexAllocator->Allocate((uint32_t)indices.size());
+            if (firstIndex == FreeListAllocator::InvalidOffset)
+            {
+                GFX_ERROR("GeometryPool: Out of index space! Requested = {}, Free = {}", indices.size(), m_indexAllocator->GetFreeSpace());
+                m_vertexAllocator->Free(baseVertex, (uint32_t)vertices.size());
+                return {};
+            }
+
+            mesh.VertexBuffer = m_vertexBuffer.get();
+            mesh.IndexBuffer = m_indexBuffer.get();
+            mesh.BaseVertex = baseVertex;
+            mesh.VertexCount = (uint32_t)vertices.size();
+            mesh.FirstIndex = firstIndex;
+            mesh.IndexCount = (uint32_t)indices.size();
+        }
+
+        OwnedPtr<UploadBatch> ownedBatch;
+        if (batch == nullptr)
+        {
+            ownedBatch = UploadBatch::Create();
+            batch = ownedBatch.get();
+        }
+
+        if (!vertices.empty())
+            batch->Upload(m_vertexBuffer.get(), sizeof(Vertex) * mesh.BaseVertex, sizeof(Vertex) * vertices.size(), vertices.data());
+        if (!indices.empty())
+            batch->Upload(m_indexBuffer.get(), sizeof(uint32_t) * mesh.FirstIndex, sizeof(uint32_t) * indices.size(), indices.data());
+
+        if (ownedBatch != nullptr) ownedBatch->Flush();
+
+        return mesh;
+    }
+
+    auto GeometryPool::Allocate(const MeshBuilder& builder, UploadBatch* batch) -> Mesh
+    {
+        return Allocate(builder.GetVertices(), builder.GetIndices(), batch);
+    }
+
+    auto GeometryPool::Allocate(const MeshImporter& importer, UploadBatch* batch) -> Mesh
+    {
+        return Allocate(importer.GetVertices(), importer.GetIndices(), batch);
+    }
+
+    void GeometryPool::Free(const Mesh& mesh)
+    {
+        if (!mesh.IsValid()) return;
+
+        GFX_ASSERT(mesh.VertexBuffer == m_vertexBuffer.get(), "Mesh was not allocated from this pool!");
+
+        std::lock_guard lock(m_mutex);
+        m_vertexAllocator->Free(mesh.BaseVertex, mesh.VertexCount);
+        m_indexAllocator->Free(mesh.FirstIndex, mesh.IndexCount);
+    }
+
+    auto GeometryPool::GetSubMesh(const Mesh& mesh, const SubMesh& subMesh) -> Mesh
+    {
+        Mesh result = mesh;
+        result.BaseVertex = mesh.BaseVertex + subMesh.BaseVertex;
+        result.VertexCount = subMesh.VertexCount;
+        result.FirstIndex = mesh.FirstIndex + subMesh.BaseIndex;
+        result.IndexCount = subMesh.IndexCount;
+        return result;
+    }
+
+    auto GeometryPool::BuildIndirectCommands(const Mesh& mesh, const std::vector<SubMesh>& subMeshes) -> std::vector<DrawIndexedIndirectCommand>
+    {
+        const bool firstInstance = CommandBuffer::IsDrawIndirectFirstInstanceSupported();
+
+        std::vector<DrawIndexedIndirectCommand> commands;
+        commands.reserve(subMeshes.size());
+
+        for (uint32_t i = 0; i < subMeshes.size(); i++)
+        {
+            const auto subMeshRange = GetSubMesh(mesh, subMeshes[i]);
+
+            auto& command = commands.emplace_back();
+            command.IndexCount = subMeshRange.IndexCount;
+            command.InstanceCount = 1;
+            command.FirstIndex = subMeshRange.FirstIndex;
+            command.VertexOffset = (int32_t)subMeshRange.BaseVertex;
+            command.FirstInstance = firstInstance ? i : 0;
+        }
+
+        return commands;
+    }
+
+    auto GeometryPool::CreateIndirectBuffer(const Mesh& mesh, const std::vector<SubMesh>& subMeshes) -> OwnedPtr<Buffer>
+    {
+        const auto commands = BuildIndirectCommands(mesh, subMeshes);
+        if (commands.empty()) return nullptr;
+
+        return Buffer::CreateIndirect(sizeof(DrawIndexedIndirectCommand) * commands.size(), commands.data());
+    }
+}
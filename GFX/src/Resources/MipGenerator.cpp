@@ -0,0 +1,265 @@
+#include "GFX/Resources/MipGenerator.h"
+
+#include "GFX/Debug.h"
+#include "Utility/Float4.h"
+#include "Utility/ParallelFor.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        constexpr float Pi = 3.14159265358979f;
+
+        // Width of the Kaiser filter in destination texels either side of the centre, and how quickly its window falls off
+        constexpr float KaiserWidth = 3.0f;
+        constexpr float KaiserAlpha = 4.0f;
+
+        // Destination texel `x` is the weighted sum of the source texels from `First` onwards
+        struct FilterTaps
+        {
+            uint32_t First = 0;
+            std::vector<float> Weights;
+        };
+
+        auto SrgbToLinear(float value) -> float
+        {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+
+        auto LinearToSrgb(float value) -> float
+        {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        }
+
+        auto ToUnorm8(float value) -> uint8_t { return uint8_t(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f)); }
+
+        auto BesselI0(float x) -> float
+        {
+            // Power series, converges quickly for the small arguments the window uses
+            float sum = 1.0f;
+            float term = 1.0f;
+            for (int k = 1; k < 32 && term > sum * 1e-7f; k++)
+            {
+                const float half = x / (2.0f * float(k));
+                term *= half * half;
+                sum += term;
+            }
+            return sum;
+        }
+
+        auto Kaiser(float x) -> float
+        {
+            if (std::abs(x) >= KaiserWidth) return 0.0f;
+
+            const float sinc = std::abs(x) < 1e-4f ? 1.0f : std::sin(Pi * x) / (Pi * x);
+            const float t = x / KaiserWidth;
+            return sinc * BesselI0(KaiserAlpha * std::sqrt(1.0f - t * t)) / BesselI0(KaiserAlpha);
+        }
+
+        // Weights of every destination texel along one axis, texels outside the image are clamped to the edge
+        auto ComputeTaps(uint32_t srcSize, uint32_t dstSize, MipFilter filter) -> std::vector<FilterTaps>
+        {
+            const float scale = float(srcSize) / float(dstSize);
+
+            std::vector<FilterTaps> taps(dstSize);
+            for (uint32_t x = 0; x < dstSize; x++)
+            {
+                float start = float(x) * scale;
+                float end = float(x + 1) * scale;
+                if (filter == MipFilter::eKaiser)
+                {
+                    const float centre = (float(x) + 0.5f) * scale;
+                    start = centre - KaiserWidth * scale;
+                    end = centre + KaiserWidth * scale;
+                }
+
+                const auto first = int32_t(std::floor(start));
+                const auto last = int32_t(std::ceil(end)) - 1;
+                const auto clampedFirst = uint32_t(std::clamp(first, 0, int32_t(srcSize) - 1));
+                const auto clampedLast = uint32_t(std::clamp(last, 0, int32_t(srcSize) - 1));
+
+                auto& texelTaps = taps[x];
+                texelTaps.First = clampedFirst;
+                texelTaps.Weights.assign(clampedLast - clampedFirst + 1, 0.0f);
+
+                float sum = 0.0f;
+                for (int32_t i = first; i <= last; i++)
+                {
+                    float weight = 0.0f;
+                    if (filter == MipFilter::eKaiser)
+                        weight = Kaiser((float(i) + 0.5f - (float(x) + 0.5f) * scale) / scale);
+                    else
+                        weight = std::min(end, float(i + 1)) - std::max(start, float(i));
+
+                    const auto index = uint32_t(std::clamp(i, 0, int32_t(srcSize) - 1));
+                    texelTaps.Weights[index - clampedFirst] += weight;
+                    sum += weight;
+                }
+
+                for (auto& weight : texelTaps.Weights)
+                {
+                    weight /= sum;
+                }
+            }
+            return taps;
+        }
+
+        // dst += src * weight for `count` floats, a multiple of 4
+        void MultiplyAdd(float* dst, const float* src, float weight, size_t count)
+        {
+            for (size_t i = 0; i < count; i += 4)
+            {
+                (Float4::Load(dst + i) + Float4::Load(src + i) * weight).Store(dst + i);
+            }
+        }
+
+        // Texels are expanded to linear RGBA floats while filtering, whatever the format stores
+        auto Decode(const uint8_t* data, uint32_t width, uint32_t height, TextureFormat format) -> std::vector<float>
+        {
+            std::array<float, 256> srgbToLinear{};
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                srgbToLinear[i] = SrgbToLinear(float(i) / 255.0f);
+            }
+
+            const size_t texelCount = size_t(width) * height;
+            std::vector<float> texels(texelCount * 4);
+            for (size_t i = 0; i < texelCount; i++)
+            {
+                float* texel = &texels[i * 4];
+                switch (format)
+                {
+                    case TextureFormat::eR:
+                        texel[0] = float(data[i]) / 255.0f;
+                        texel[1] = 0.0f;
+                        texel[2] = 0.0f;
+                        texel[3] = 1.0f;
+                        break;
+                    case TextureFormat::eRGBA:
+                        texel[0] = srgbToLinear[data[i * 4]];
+                        texel[1] = srgbToLinear[data[i * 4 + 1]];
+                        texel[2] = srgbToLinear[data[i * 4 + 2]];
+                        texel[3] = float(data[i * 4 + 3]) / 255.0f;
+                        break;
+                    case TextureFormat::eRGBA16f:
+                        for (uint32_t c = 0; c < 4; c++)
+                        {
+                            uint16_t half = 0;
+                            std::memcpy(&half, data + i * 8 + c * 2, sizeof(half));
+                            texel[c] = glm::unpackHalf1x16(half);
+                        }
+                        break;
+                    default: break;
+                }
+            }
+            return texels;
+        }
+
+        void Encode(const std::vector<float>& texels, TextureFormat format, std::vector<uint8_t>& data)
+        {
+            const size_t texelCount = texels.size() / 4;
+            const size_t offset = data.size();
+            data.resize(offset + texelCount * GetFormatSize(format));
+
+            uint8_t* dst = data.data() + offset;
+            for (size_t i = 0; i < texelCount; i++)
+            {
+                const float* texel = &texels[i * 4];
+                switch (format)
+                {
+                    case TextureFormat::eR: dst[i] = ToUnorm8(texel[0]); break;
+                    case TextureFormat::eRGBA:
+                        dst[i * 4] = ToUnorm8(LinearToSrgb(std::max(texel[0], 0.0f)));
+                        dst[i * 4 + 1] = ToUnorm8(LinearToSrgb(std::max(texel[1], 0.0f)));
+                        dst[i * 4 + 2] = ToUnorm8(LinearToSrgb(std::max(texel[2], 0.0f)));
+                        dst[i * 4 + 3] = ToUnorm8(texel[3]);
+                        break;
+                    case TextureFormat::eRGBA16f:
+                        for (uint32_t c = 0; c < 4; c++)
+                        {
+                            const uint16_t half = glm::packHalf1x16(texel[c]);
+                            std::memcpy(dst + i * 8 + c * 2, &half, sizeof(half));
+                        }
+                        break;
+                    default: break;
+                }
+            }
+        }
+
+        // Separable resample of RGBA float texels, rows first then columns, both spread across worker threads
+        auto Downsample(const std::vector<float>& src, uint32_t srcWidth, uint32_t srcHeight, uint32_t dstWidth, uint32_t dstHeight, MipFilter filter)
+            -> std::vector<float>
+        {
+            const auto columnTaps = ComputeTaps(srcWidth, dstWidth, filter);
+            const auto rowTaps = ComputeTaps(srcHeight, dstHeight, filter);
+
+            std::vector<float> horizontal(size_t(dstWidth) * srcHeight * 4, 0.0f);
+            ParallelFor(srcHeight,
+                        [&](uint32_t y)
+                        {
+                            const float* srcRow = &src[size_t(y) * srcWidth * 4];
+                            float* dstRow = &horizontal[size_t(y) * dstWidth * 4];
+                            for (uint32_t x = 0; x < dstWidth; x++)
+                            {
+                                const auto& taps = columnTaps[x];
+                                for (size_t i = 0; i < taps.Weights.size(); i++)
+                                {
+                                    MultiplyAdd(&dstRow[x * 4], &srcRow[(taps.First + i) * 4], taps.Weights[i], 4);
+                                }
+                            }
+                        });
+
+            // Whole rows are accumulated at once, so the inner loop runs over contiguous memory
+            std::vector<float> dst(size_t(dstWidth) * dstHeight * 4, 0.0f);
+            ParallelFor(dstHeight,
+                        [&](uint32_t y)
+                        {
+                            const auto& taps = rowTaps[y];
+                            float* dstRow = &dst[size_t(y) * dstWidth * 4];
+                            for (size_t i = 0; i < taps.Weights.size(); i++)
+                            {
+                                MultiplyAdd(dstRow, &horizontal[(taps.First + i) * dstWidth * 4], taps.Weights[i], size_t(dstWidth) * 4);
+                            }
+                        });
+            return dst;
+        }
+    }
+
+    auto GenerateMips(const std::vector<uint8_t>& data, uint32_t width, uint32_t height, TextureFormat format, MipFilter filter, uint32_t mips)
+        -> std::vector<uint8_t>
+    {
+        GFX_ASSERT(format == TextureFormat::eR || format == TextureFormat::eRGBA || format == TextureFormat::eRGBA16f,
+                   "Mips can only be generated for colour formats!");
+
+        const auto levelSize = CalculateTextureSize(width, height, format);
+        GFX_ASSERT(data.size() >= levelSize, "Texture data is smaller than its first level!");
+
+        const auto mipCount = mips == 0 ? CalculateMipCount(width, height) : std::min(mips, CalculateMipCount(width, height));
+
+        std::vector<uint8_t> chain;
+        chain.reserve(CalculateTextureSize(width, height, format, mipCount));
+        chain.insert(chain.end(), data.begin(), data.begin() + levelSize);
+
+        // Every level is filtered from the one before it, sharing the work of the larger levels
+        auto texels = Utils::Decode(data.data(), width, height, format);
+        for (uint32_t mip = 1; mip < mipCount; mip++)
+        {
+            const auto mipWidth = std::max(width >> 1, 1u);
+            const auto mipHeight = std::max(height >> 1, 1u);
+
+            texels = Utils::Downsample(texels, width, height, mipWidth, mipHeight, filter);
+            Utils::Encode(texels, format, chain);
+
+            width = mipWidth;
+            height = mipHeight;
+        }
+        return chain;
+    }
+}
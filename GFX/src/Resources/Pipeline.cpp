@@ -1,6 +1,7 @@
 ﻿#include "GFX/Resources/Pipeline.h"
 
 #include "GFX/Core/GFXCore.h"
+#include "Platform/Vulkan/VulkanBackend.h"
 #include "Platform/Vulkan/VulkanPipeline.h"
 
 namespace gfx
@@ -16,4 +17,28 @@ namespace gfx
         }
         return nullptr;
     }
+
+    auto Pipeline::CreateAsync(const PipelineDesc& desc, Pipeline* placeholder, std::function<void()> onReady) -> OwnedPtr<Pipeline>
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return CreateOwned<VulkanPipeline>(desc, static_cast<VulkanPipeline*>(placeholder), std::move(onReady));
+            case BackendType::eNone:
+            default: break;
+        }
+        return nullptr;
+    }
+
+    auto Pipeline::GetRegistryStats() -> PipelineRegistryStats
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return VulkanBackend::Get()->GetPipelineRegistry().GetStats();
+            case BackendType::eNone:
+            default: break;
+        }
+        return {};
+    }
 }
@@ -0,0 +1,19 @@
+#include "GFX/Resources/PipelineManifest.h"
+
+#include "GFX/Core/GFXCore.h"
+#include "Platform/Vulkan/VulkanPipelineManifest.h"
+
+namespace gfx
+{
+    auto PipelineManifest::Replay(const std::string& filename, const std::vector<Framebuffer*>& framebuffers) -> OwnedPtr<PipelineManifest>
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return CreateOwned<VulkanPipelineManifest>(filename, framebuffers);
+            case BackendType::eNone:
+            default: break;
+        }
+        return nullptr;
+    }
+}
@@ -4,20 +4,151 @@
 #include "GFX/Resources/ResourceSet.h"
 #include "Platform/Vulkan/VulkanShader.h"
 
+#include "GFX/Debug.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+
 namespace gfx
 {
+    namespace Utils
+    {
+        auto Trim(std::string_view str) -> std::string_view
+        {
+            const auto first = str.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos) return {};
+
+            const auto last = str.find_last_not_of(" \t\r");
+            return str.substr(first, last - first + 1);
+        }
+    }
+
     auto Shader::Create(const std::string& vertexSource, const std::string& pixelSource) -> OwnedPtr<Shader>
+    {
+        ShaderSources sources{};
+        sources.VertexSource = vertexSource;
+        sources.PixelSource = pixelSource;
+        return Create(sources);
+    }
+
+    auto Shader::Create(const ShaderSources& sources) -> OwnedPtr<Shader>
     {
         auto backendType = gfx::GetBackendType();
         switch (backendType)
         {
-            case BackendType::eVulkan: return CreateOwned<VulkanShader>(vertexSource, pixelSource);
+            case BackendType::eVulkan: return CreateOwned<VulkanShader>(sources);
             case BackendType::eNone:
             default: break;
         }
         return nullptr;
     }
 
+    auto Shader::CreateCompute(const std::string& computeSource) -> OwnedPtr<Shader>
+    {
+        ShaderSources sources{};
+        sources.ComputeSource = computeSource;
+        return Create(sources);
+    }
+
+    auto Shader::CreateFromFile(const std::string& filename) -> OwnedPtr<Shader>
+    {
+        ShaderSources sources{};
+        if (!LoadSources(filename, sources)) return nullptr;
+
+        return Create(sources);
+    }
+
+    bool Shader::LoadSources(const std::string& filename, ShaderSources& sources)
+    {
+        std::ifstream file(filename);
+        if (!file)
+        {
+            GFX_ERROR("Failed to open shader file '{}'!", filename);
+            return false;
+        }
+
+        sources = {};
+        sources.SourcePath = filename;
+
+        // Lines of the other stages are kept as empty lines, so line numbers in compile errors match the file
+        std::string* stageSource = nullptr;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            const auto trimmed = Utils::Trim(line);
+            if (trimmed.starts_with("#type"))
+            {
+                const auto type = Utils::Trim(trimmed.substr(5));
+                if (type == "vertex")
+                    stageSource = &sources.VertexSource;
+                else if (type == "pixel" || type == "fragment")
+                    stageSource = &sources.PixelSource;
+                else if (type == "compute")
+                    stageSource = &sources.ComputeSource;
+                else
+                {
+                    GFX_ERROR("Unknown shader type '{}' in '{}'!", type, filename);
+                    return false;
+                }
+            }
+            else if (trimmed.starts_with("#keywords"))
+            {
+                auto keywords = trimmed.substr(9);
+                while (!(keywords = Utils::Trim(keywords)).empty())
+                {
+                    const auto end = std::min(keywords.find_first_of(" \t"), keywords.size());
+                    sources.Keywords.emplace_back(keywords.substr(0, end));
+                    keywords = keywords.substr(end);
+                }
+            }
+            else if (stageSource != nullptr)
+            {
+                *stageSource += line;
+            }
+
+            sources.VertexSource += '\n';
+            sources.PixelSource += '\n';
+            sources.ComputeSource += '\n';
+        }
+
+        const auto hasStage = [](const std::string& source) { return source.find_first_not_of('\n') != std::string::npos; };
+        if (hasStage(sources.ComputeSource))
+        {
+            if (hasStage(sources.VertexSource) || hasStage(sources.PixelSource))
+            {
+                GFX_ERROR("Shader file '{}' cannot mix a compute stage with graphics stages!", filename);
+                return false;
+            }
+
+            sources.VertexSource.clear();
+            sources.PixelSource.clear();
+        }
+        else if (!hasStage(sources.VertexSource) || !hasStage(sources.PixelSource))
+        {
+            GFX_ERROR("Shader file '{}' needs both a vertex and a pixel stage!", filename);
+            return false;
+        }
+        else
+        {
+            sources.ComputeSource.clear();
+        }
+
+        return true;
+    }
+
+    auto Shader::CreateBatch(const std::vector<ShaderSources>& sources) -> std::vector<OwnedPtr<Shader>>
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return VulkanShader::CreateBatch(sources);
+            case BackendType::eNone:
+            default: break;
+        }
+        return {};
+    }
+
     auto Shader::AllocateResourceSet(uint32_t frameIndex,
                                      uint32_t set) -> OwnedPtr<ResourceSet>
     {
@@ -2,43 +2,56 @@
 
 #include "GFX/Core/GFXCore.h"
 #include "GFX/Resources/ResourceSet.h"
+#include "Platform/Vulkan/VulkanBackend.h"
 #include "Platform/Vulkan/VulkanTexture.h"
 
 namespace gfx
 {
-    auto Texture::Create(const TextureBuilder& builder) -> OwnedPtr<Texture>
+    auto Texture::Create(const TextureBuilder& builder, const SamplerDesc& sampler, UploadBatch* batch) -> OwnedPtr<Texture>
     {
         auto backendType = gfx::GetBackendType();
         switch (backendType)
         {
-            case BackendType::eVulkan: return CreateOwned<VulkanTexture>(builder);
+            case BackendType::eVulkan: return CreateOwned<VulkanTexture>(builder, sampler, batch);
             case BackendType::eNone:
             default: break;
         }
         return nullptr;
     }
 
-    auto Texture::Create(const TextureImporter& importer) -> OwnedPtr<Texture>
+    auto Texture::Create(const TextureImporter& importer, const SamplerDesc& sampler, UploadBatch* batch) -> OwnedPtr<Texture>
     {
         auto backendType = gfx::GetBackendType();
         switch (backendType)
         {
-            case BackendType::eVulkan: return CreateOwned<VulkanTexture>(importer);
+            case BackendType::eVulkan: return CreateOwned<VulkanTexture>(importer, sampler, batch);
             case BackendType::eNone:
             default: break;
         }
         return nullptr;
     }
 
-    auto Texture::Create(const TextureDesc& desc, const std::vector<uint8_t>& data) -> OwnedPtr<Texture>
+    auto Texture::Create(const TextureDesc& desc, const std::vector<uint8_t>& data, UploadBatch* batch) -> OwnedPtr<Texture>
     {
         auto backendType = gfx::GetBackendType();
         switch (backendType)
         {
-            case BackendType::eVulkan: return CreateOwned<VulkanTexture>(desc, data);
+            case BackendType::eVulkan: return CreateOwned<VulkanTexture>(desc, data, batch);
             case BackendType::eNone:
             default: break;
         }
         return nullptr;
     }
+
+    bool Texture::IsBindlessSupported()
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return VulkanBackend::Get()->GetTextureTable().IsSupported();
+            case BackendType::eNone:
+            default: break;
+        }
+        return false;
+    }
 }
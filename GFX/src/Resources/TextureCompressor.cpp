@@ -0,0 +1,639 @@
+#include "GFX/Resources/TextureCompressor.h"
+
+#include "GFX/Debug.h"
+#include "Utility/Float4.h"
+#include "Utility/ParallelFor.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace gfx
+{
+    namespace Utils
+    {
+        // Texels of a 4x4 block as floats in [0, 255], row by row
+        using Block = std::array<Float4, 16>;
+        using BlockIndices = std::array<uint8_t, 16>;
+
+        struct EncodeSettings
+        {
+            bool PrincipalAxis = false;     // Endpoints along the axis of greatest variance instead of the bounding box diagonal
+            uint32_t Refinements = 0;       // Least squares passes fitting the endpoints to the chosen indices
+            bool ExhaustiveSearch = false;  // Also tries BC4's six value mode and every BC7 p-bit combination
+        };
+
+        auto GetEncodeSettings(CompressionQuality quality) -> EncodeSettings
+        {
+            switch (quality)
+            {
+                case CompressionQuality::eFast: return { false, 0, false };
+                case CompressionQuality::eNormal: return { true, 1, false };
+                case CompressionQuality::eHigh: return { true, 4, true };
+                default: break;
+            }
+            return {};
+        }
+
+        // Texels past the right and bottom edge repeat the last column and row, so they do not pull the endpoints away
+        auto LoadBlock(const uint8_t* data, uint32_t width, uint32_t height, TextureFormat format, uint32_t blockX, uint32_t blockY) -> Block
+        {
+            Block block;
+            for (uint32_t y = 0; y < 4; y++)
+            {
+                for (uint32_t x = 0; x < 4; x++)
+                {
+                    const auto texelX = std::min(blockX * 4 + x, width - 1);
+                    const auto texelY = std::min(blockY * 4 + y, height - 1);
+                    const auto index = size_t(texelY) * width + texelX;
+                    if (format == TextureFormat::eR)
+                    {
+                        block[y * 4 + x] = Float4::Set(float(data[index]), 0.0f, 0.0f, 255.0f);
+                    }
+                    else
+                    {
+                        const uint8_t* texel = data + index * 4;
+                        block[y * 4 + x] = Float4::Set(float(texel[0]), float(texel[1]), float(texel[2]), float(texel[3]));
+                    }
+                }
+            }
+            return block;
+        }
+
+        auto Clamp255(const Float4& value) -> Float4 { return Min(Max(value, Float4::Splat(0.0f)), Float4::Splat(255.0f)); }
+
+        // Endpoints spanning the texels along the block's principal axis, or the corners of its bounding box
+        void FindEndpoints(const Block& block, bool principalAxis, Float4& e0, Float4& e1)
+        {
+            Float4 minimum = Float4::Splat(255.0f);
+            Float4 maximum = Float4::Splat(0.0f);
+            Float4 mean = Float4::Splat(0.0f);
+            for (const auto& texel : block)
+            {
+                minimum = Min(minimum, texel);
+                maximum = Max(maximum, texel);
+                mean += texel;
+            }
+            mean = mean * (1.0f / 16.0f);
+
+            const auto diagonal = maximum - minimum;
+            if (!principalAxis || Dot(diagonal, diagonal) < 1e-3f)
+            {
+                // Interpolated colours rarely reach the corners, insetting them lowers the error of the texels in between
+                const auto inset = diagonal * (1.0f / 16.0f);
+                e0 = maximum - inset;
+                e1 = minimum + inset;
+                return;
+            }
+
+            std::array<float, 16> covariance{};
+            for (const auto& texel : block)
+            {
+                float d[4];
+                (texel - mean).Store(d);
+                for (int i = 0; i < 4; i++)
+                {
+                    for (int j = 0; j < 4; j++)
+                    {
+                        covariance[i * 4 + j] += d[i] * d[j];
+                    }
+                }
+            }
+
+            const std::array rows = { Float4::Load(&covariance[0]), Float4::Load(&covariance[4]), Float4::Load(&covariance[8]), Float4::Load(&covariance[12]) };
+
+            // Power iteration, starting from the diagonal which is usually close already
+            auto axis = diagonal;
+            for (int i = 0; i < 8; i++)
+            {
+                const auto next = Float4::Set(Dot(rows[0], axis), Dot(rows[1], axis), Dot(rows[2], axis), Dot(rows[3], axis));
+                const float length = std::sqrt(Dot(next, next));
+                if (length < 1e-6f) break;
+
+                axis = next * (1.0f / length);
+            }
+            axis = axis * (1.0f / std::sqrt(Dot(axis, axis)));
+
+            float minProjection = std::numeric_limits<float>::max();
+            float maxProjection = std::numeric_limits<float>::lowest();
+            for (const auto& texel : block)
+            {
+                const float projection = Dot(texel - mean, axis);
+                minProjection = std::min(minProjection, projection);
+                maxProjection = std::max(maxProjection, projection);
+            }
+
+            e0 = Clamp255(mean + axis * maxProjection);
+            e1 = Clamp255(mean + axis * minProjection);
+        }
+
+        // Picks the closest palette entry for every texel, returns the summed squared error
+        template <size_t N>
+        auto SelectIndices(const Block& block, const std::array<Float4, N>& palette, BlockIndices& indices) -> float
+        {
+            float error = 0.0f;
+            for (size_t i = 0; i < block.size(); i++)
+            {
+                float bestError = std::numeric_limits<float>::max();
+                for (size_t j = 0; j < N; j++)
+                {
+                    const auto difference = block[i] - palette[j];
+                    const float texelError = Dot(difference, difference);
+                    if (texelError < bestError)
+                    {
+                        bestError = texelError;
+                        indices[i] = uint8_t(j);
+                    }
+                }
+                error += bestError;
+            }
+            return error;
+        }
+
+        // Least squares endpoints for fixed indices, `weights` is how much of e1 each index interpolates
+        bool RefineEndpoints(const Block& block, const BlockIndices& indices, const float* weights, Float4& e0, Float4& e1)
+        {
+            float aa = 0.0f;
+            float bb = 0.0f;
+            float ab = 0.0f;
+            Float4 ax = Float4::Splat(0.0f);
+            Float4 bx = Float4::Splat(0.0f);
+            for (size_t i = 0; i < block.size(); i++)
+            {
+                const float b = weights[indices[i]];
+                const float a = 1.0f - b;
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                ax += block[i] * a;
+                bx += block[i] * b;
+            }
+
+            const float determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) < 1e-6f) return false;
+
+            const float scale = 1.0f / determinant;
+            e0 = Clamp255((ax * bb - bx * ab) * scale);
+            e1 = Clamp255((bx * aa - ax * ab) * scale);
+            return true;
+        }
+
+        /* BC1 */
+
+        constexpr float BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+        auto QuantizeRGB565(const Float4& color) -> uint16_t
+        {
+            const auto r = uint16_t(std::lround(color[0] * 31.0f / 255.0f));
+            const auto g = uint16_t(std::lround(color[1] * 63.0f / 255.0f));
+            const auto b = uint16_t(std::lround(color[2] * 31.0f / 255.0f));
+            return uint16_t((r << 11) | (g << 5) | b);
+        }
+
+        auto ExpandRGB565(uint16_t color) -> Float4
+        {
+            const uint32_t r = (color >> 11) & 31;
+            const uint32_t g = (color >> 5) & 63;
+            const uint32_t b = color & 31;
+            return Float4::Set(float((r << 3) | (r >> 2)), float((g << 2) | (g >> 4)), float((b << 3) | (b >> 2)), 0.0f);
+        }
+
+        auto GetBC1Palette(uint16_t c0, uint16_t c1) -> std::array<Float4, 4>
+        {
+            const auto p0 = ExpandRGB565(c0);
+            const auto p1 = ExpandRGB565(c1);
+            return { p0, p1, (p0 * 2.0f + p1) * (1.0f / 3.0f), (p0 + p1 * 2.0f) * (1.0f / 3.0f) };
+        }
+
+        // Always the four colour mode, which is also the only one the colour block of BC3 has
+        void EncodeBC1(Block block, const EncodeSettings& settings, uint8_t* output)
+        {
+            for (auto& texel : block)
+            {
+                texel = texel * Float4::Set(1.0f, 1.0f, 1.0f, 0.0f);
+            }
+
+            Float4 e0;
+            Float4 e1;
+            FindEndpoints(block, settings.PrincipalAxis, e0, e1);
+
+            auto c0 = QuantizeRGB565(e0);
+            auto c1 = QuantizeRGB565(e1);
+            BlockIndices indices{};
+            float error = SelectIndices(block, GetBC1Palette(c0, c1), indices);
+
+            for (uint32_t i = 0; i < settings.Refinements; i++)
+            {
+                if (!RefineEndpoints(block, indices, BC1Weights, e0, e1)) break;
+
+                const auto r0 = QuantizeRGB565(e0);
+                const auto r1 = QuantizeRGB565(e1);
+                if (r0 == c0 && r1 == c1) break;
+
+                BlockIndices refinedIndices{};
+                const float refinedError = SelectIndices(block, GetBC1Palette(r0, r1), refinedIndices);
+                if (refinedError >= error) break;
+
+                c0 = r0;
+                c1 = r1;
+                indices = refinedIndices;
+                error = refinedError;
+            }
+
+            // c0 > c1 selects the four colour mode, swapping the endpoints swaps the two pairs of indices
+            if (c0 < c1)
+            {
+                std::swap(c0, c1);
+                for (auto& index : indices)
+                {
+                    index ^= 1;
+                }
+            }
+            else if (c0 == c1)
+            {
+                indices.fill(0);
+            }
+
+            uint32_t bits = 0;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                bits |= uint32_t(indices[i]) << (i * 2);
+            }
+
+            output[0] = uint8_t(c0);
+            output[1] = uint8_t(c0 >> 8);
+            output[2] = uint8_t(c1);
+            output[3] = uint8_t(c1 >> 8);
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                output[4 + i] = uint8_t(bits >> (i * 8));
+            }
+        }
+
+        /* BC4 */
+
+        constexpr float BC4Weights[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+
+        // a0 > a1 interpolates eight values, otherwise six plus 0 and 255
+        auto GetBC4Palette(int32_t a0, int32_t a1) -> std::array<float, 8>
+        {
+            std::array<float, 8> palette{ float(a0), float(a1) };
+            if (a0 > a1)
+            {
+                for (int32_t i = 1; i < 7; i++)
+                {
+                    palette[i + 1] = float((7 - i) * a0 + i * a1) / 7.0f;
+                }
+            }
+            else
+            {
+                for (int32_t i = 1; i < 5; i++)
+                {
+                    palette[i + 1] = float((5 - i) * a0 + i * a1) / 5.0f;
+                }
+                palette[6] = 0.0f;
+                palette[7] = 255.0f;
+            }
+            return palette;
+        }
+
+        auto SelectBC4Indices(const std::array<float, 16>& values, const std::array<float, 8>& palette, BlockIndices& indices) -> float
+        {
+            float error = 0.0f;
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                float bestError = std::numeric_limits<float>::max();
+                for (size_t j = 0; j < palette.size(); j++)
+                {
+                    const float texelError = (values[i] - palette[j]) * (values[i] - palette[j]);
+                    if (texelError < bestError)
+                    {
+                        bestError = texelError;
+                        indices[i] = uint8_t(j);
+                    }
+                }
+                error += bestError;
+            }
+            return error;
+        }
+
+        void EncodeBC4(const Block& block, int channel, const EncodeSettings& settings, uint8_t* output)
+        {
+            std::array<float, 16> values{};
+            float minimum = 255.0f;
+            float maximum = 0.0f;
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                values[i] = block[i][channel];
+                minimum = std::min(minimum, values[i]);
+                maximum = std::max(maximum, values[i]);
+            }
+
+            auto a0 = int32_t(maximum);
+            auto a1 = int32_t(minimum);
+            BlockIndices indices{};
+            float error = SelectBC4Indices(values, GetBC4Palette(a0, a1), indices);
+
+            for (uint32_t i = 0; i < settings.Refinements && a0 > a1; i++)
+            {
+                float aa = 0.0f;
+                float bb = 0.0f;
+                float ab = 0.0f;
+                float ax = 0.0f;
+                float bx = 0.0f;
+                for (size_t j = 0; j < values.size(); j++)
+                {
+                    const float b = BC4Weights[indices[j]];
+                    const float a = 1.0f - b;
+                    aa += a * a;
+                    bb += b * b;
+                    ab += a * b;
+                    ax += values[j] * a;
+                    bx += values[j] * b;
+                }
+
+                const float determinant = aa * bb - ab * ab;
+                if (std::abs(determinant) < 1e-6f) break;
+
+                const auto r0 = int32_t(std::lround(std::clamp((ax * bb - bx * ab) / determinant, 0.0f, 255.0f)));
+                const auto r1 = int32_t(std::lround(std::clamp((bx * aa - ax * ab) / determinant, 0.0f, 255.0f)));
+                if (r0 <= r1 || (r0 == a0 && r1 == a1)) break;
+
+                BlockIndices refinedIndices{};
+                const float refinedError = SelectBC4Indices(values, GetBC4Palette(r0, r1), refinedIndices);
+                if (refinedError >= error) break;
+
+                a0 = r0;
+                a1 = r1;
+                indices = refinedIndices;
+                error = refinedError;
+            }
+
+            if (settings.ExhaustiveSearch && error > 0.0f)
+            {
+                // Blocks with values at both extremes fit better when 0 and 255 are explicit and the rest is interpolated
+                float innerMinimum = 255.0f;
+                float innerMaximum = 0.0f;
+                for (const float value : values)
+                {
+                    if (value == 0.0f || value == 255.0f) continue;
+
+                    innerMinimum = std::min(innerMinimum, value);
+                    innerMaximum = std::max(innerMaximum, value);
+                }
+
+                // Without any values in between the endpoints are unused, 0 and 255 keep them valid
+                const bool hasInner = innerMinimum <= innerMaximum;
+                const auto b0 = hasInner ? int32_t(innerMinimum) : 0;
+                const auto b1 = hasInner ? int32_t(innerMaximum) : 255;
+                BlockIndices sixIndices{};
+                const float sixError = SelectBC4Indices(values, GetBC4Palette(b0, b1), sixIndices);
+                if (sixError < error)
+                {
+                    a0 = b0;
+                    a1 = b1;
+                    indices = sixIndices;
+                }
+            }
+
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                bits |= uint64_t(indices[i]) << (i * 3);
+            }
+
+            output[0] = uint8_t(a0);
+            output[1] = uint8_t(a1);
+            for (uint32_t i = 0; i < 6; i++)
+            {
+                output[2 + i] = uint8_t(bits >> (i * 8));
+            }
+        }
+
+        /* BC7, mode 6 only: one subset of RGBA endpoints with 7 bits per channel and a p-bit each, and 4 bit indices */
+
+        constexpr int32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        struct BC7Endpoint
+        {
+            std::array<uint32_t, 4> Color{};  // 7 bits per channel
+            uint32_t PBit = 0;                // Shared lowest bit of every channel
+
+            auto Expand() const -> std::array<int32_t, 4>
+            {
+                return { int32_t(Color[0] << 1 | PBit), int32_t(Color[1] << 1 | PBit), int32_t(Color[2] << 1 | PBit), int32_t(Color[3] << 1 | PBit) };
+            }
+        };
+
+        auto QuantizeBC7(const Float4& color, uint32_t pBit) -> BC7Endpoint
+        {
+            BC7Endpoint endpoint{};
+            endpoint.PBit = pBit;
+            for (int i = 0; i < 4; i++)
+            {
+                endpoint.Color[i] = uint32_t(std::clamp(std::lround((color[i] - float(pBit)) * 0.5f), 0l, 127l));
+            }
+            return endpoint;
+        }
+
+        auto GetQuantizationError(const Float4& color, const BC7Endpoint& endpoint) -> float
+        {
+            const auto expanded = endpoint.Expand();
+            const auto difference = color - Float4::Set(float(expanded[0]), float(expanded[1]), float(expanded[2]), float(expanded[3]));
+            return Dot(difference, difference);
+        }
+
+        auto GetBC7Palette(const BC7Endpoint& e0, const BC7Endpoint& e1) -> std::array<Float4, 16>
+        {
+            const auto a = e0.Expand();
+            const auto b = e1.Expand();
+
+            std::array<Float4, 16> palette;
+            for (int i = 0; i < 16; i++)
+            {
+                const int32_t w = BC7Weights[i];
+                palette[i] = Float4::Set(float(((64 - w) * a[0] + w * b[0] + 32) >> 6),
+                                         float(((64 - w) * a[1] + w * b[1] + 32) >> 6),
+                                         float(((64 - w) * a[2] + w * b[2] + 32) >> 6),
+                                         float(((64 - w) * a[3] + w * b[3] + 32) >> 6));
+            }
+            return palette;
+        }
+
+        // Quantizes both endpoints and selects indices, trying every p-bit combination or only the closest p-bit of each
+        auto FitBC7(const Block& block, const Float4& e0, const Float4& e1, bool exhaustive, BC7Endpoint& q0, BC7Endpoint& q1, BlockIndices& indices)
+            -> float
+        {
+            if (!exhaustive)
+            {
+                const auto pick = [](const Float4& color)
+                {
+                    const auto zero = QuantizeBC7(color, 0);
+                    const auto one = QuantizeBC7(color, 1);
+                    return GetQuantizationError(color, zero) <= GetQuantizationError(color, one) ? zero : one;
+                };
+                q0 = pick(e0);
+                q1 = pick(e1);
+                return SelectIndices(block, GetBC7Palette(q0, q1), indices);
+            }
+
+            float bestError = std::numeric_limits<float>::max();
+            for (uint32_t p = 0; p < 4; p++)
+            {
+                const auto c0 = QuantizeBC7(e0, p & 1);
+                const auto c1 = QuantizeBC7(e1, p >> 1);
+                BlockIndices candidateIndices{};
+                const float error = SelectIndices(block, GetBC7Palette(c0, c1), candidateIndices);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    q0 = c0;
+                    q1 = c1;
+                    indices = candidateIndices;
+                }
+            }
+            return bestError;
+        }
+
+        // Packs fields least significant bit first
+        class BitWriter
+        {
+        public:
+            BitWriter(uint8_t* output) : m_output(output) { std::fill(m_output, m_output + 16, uint8_t(0)); }
+
+            void Write(uint32_t value, uint32_t bits)
+            {
+                for (uint32_t i = 0; i < bits; i++, m_position++)
+                {
+                    m_output[m_position / 8] |= uint8_t(((value >> i) & 1) << (m_position % 8));
+                }
+            }
+
+        private:
+            uint8_t* m_output = nullptr;
+            uint32_t m_position = 0;
+        };
+
+        void EncodeBC7(const Block& block, const EncodeSettings& settings, uint8_t* output)
+        {
+            Float4 e0;
+            Float4 e1;
+            FindEndpoints(block, settings.PrincipalAxis, e0, e1);
+
+            BC7Endpoint q0;
+            BC7Endpoint q1;
+            BlockIndices indices{};
+            float error = FitBC7(block, e0, e1, settings.ExhaustiveSearch, q0, q1, indices);
+
+            float weights[16];
+            for (int i = 0; i < 16; i++)
+            {
+                weights[i] = float(BC7Weights[i]) / 64.0f;
+            }
+
+            for (uint32_t i = 0; i < settings.Refinements && error > 0.0f; i++)
+            {
+                if (!RefineEndpoints(block, indices, weights, e0, e1)) break;
+
+                BC7Endpoint r0;
+                BC7Endpoint r1;
+                BlockIndices refinedIndices{};
+                const float refinedError = FitBC7(block, e0, e1, settings.ExhaustiveSearch, r0, r1, refinedIndices);
+                if (refinedError >= error) break;
+
+                q0 = r0;
+                q1 = r1;
+                indices = refinedIndices;
+                error = refinedError;
+            }
+
+            // The first texel's index has an implicit leading zero, swapping the endpoints inverts the indices
+            if (indices[0] >= 8)
+            {
+                std::swap(q0, q1);
+                for (auto& index : indices)
+                {
+                    index = uint8_t(15 - index);
+                }
+            }
+
+            BitWriter writer(output);
+            writer.Write(1 << 6, 7);  // Mode 6
+            for (int channel = 0; channel < 4; channel++)
+            {
+                writer.Write(q0.Color[channel], 7);
+                writer.Write(q1.Color[channel], 7);
+            }
+            writer.Write(q0.PBit, 1);
+            writer.Write(q1.PBit, 1);
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                writer.Write(indices[i], i == 0 ? 3 : 4);
+            }
+        }
+
+        void EncodeBlock(const Block& block, TextureFormat format, const EncodeSettings& settings, uint8_t* output)
+        {
+            switch (format)
+            {
+                case TextureFormat::eBC1: EncodeBC1(block, settings, output); break;
+                case TextureFormat::eBC3:
+                    EncodeBC4(block, 3, settings, output);
+                    EncodeBC1(block, settings, output + 8);
+                    break;
+                case TextureFormat::eBC4: EncodeBC4(block, 0, settings, output); break;
+                case TextureFormat::eBC5:
+                    EncodeBC4(block, 0, settings, output);
+                    EncodeBC4(block, 1, settings, output + 8);
+                    break;
+                case TextureFormat::eBC7: EncodeBC7(block, settings, output); break;
+                default: break;
+            }
+        }
+    }
+
+    auto CompressTexture(const std::vector<uint8_t>& data,
+                         uint32_t width,
+                         uint32_t height,
+                         TextureFormat format,
+                         TextureFormat compressedFormat,
+                         CompressionQuality quality,
+                         uint32_t mips) -> std::vector<uint8_t>
+    {
+        GFX_ASSERT(format == TextureFormat::eRGBA || format == TextureFormat::eR, "Only eRGBA and eR textures can be compressed!");
+        GFX_ASSERT(IsCompressedFormat(compressedFormat), "Textures can only be compressed to block compressed formats!");
+        GFX_ASSERT(data.size() >= CalculateTextureSize(width, height, format, mips), "Texture data is smaller than its levels!");
+
+        const auto settings = Utils::GetEncodeSettings(quality);
+        const auto blockSize = GetBlockSize(compressedFormat);
+
+        std::vector<uint8_t> compressed(CalculateTextureSize(width, height, compressedFormat, mips));
+        size_t srcOffset = 0;
+        size_t dstOffset = 0;
+        for (uint32_t mip = 0; mip < mips; mip++)
+        {
+            const auto mipWidth = std::max(width >> mip, 1u);
+            const auto mipHeight = std::max(height >> mip, 1u);
+            const auto blocksX = (mipWidth + 3) / 4;
+            const auto blocksY = (mipHeight + 3) / 4;
+
+            // Blocks are independent, rows of them are spread across the worker threads
+            const uint8_t* src = data.data() + srcOffset;
+            uint8_t* dst = compressed.data() + dstOffset;
+            ParallelFor(blocksY,
+                        [&](uint32_t blockY)
+                        {
+                            for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+                            {
+                                const auto block = Utils::LoadBlock(src, mipWidth, mipHeight, format, blockX, blockY);
+                                Utils::EncodeBlock(block, compressedFormat, settings, dst + (size_t(blockY) * blocksX + blockX) * blockSize);
+                            }
+                        });
+
+            srcOffset += CalculateTextureSize(mipWidth, mipHeight, format);
+            dstOffset += CalculateTextureSize(mipWidth, mipHeight, compressedFormat);
+        }
+        return compressed;
+    }
+}
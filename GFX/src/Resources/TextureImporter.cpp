@@ -2,6 +2,8 @@
 
 #include "GFX/Debug.h"
 #include "GFX/Resources/Texture.h"
+#include "GFX/Resources/MipGenerator.h"
+#include "GFX/Resources/TextureCompressor.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_FAILURE_USERMSG
@@ -47,4 +49,15 @@ namespace gfx
         m_width = textureWidth;
         m_height = textureHeight;
     }
+
+    void TextureImporter::Compress(TextureFormat format, CompressionQuality quality)
+    {
+        if (m_data.empty() || IsCompressedFormat(m_format)) return;
+
+        // Compressed textures can not blit their mips at upload, every level is generated before it is compressed
+        const auto mips = CalculateMipCount(m_width, m_height);
+        const auto chain = GenerateMips(m_data, m_width, m_height, m_format, MipFilter::eBox, mips);
+        m_data = CompressTexture(chain, m_width, m_height, m_format, format, quality, mips);
+        m_format = format;
+    }
 }
@@ -1,7 +1,10 @@
 ﻿#include "GFX/Resources/UniformBuffer.h"
 
+#include "GFX/Debug.h"
 #include "GFX/Resources/Buffer.h"
 
+#include <algorithm>
+
 namespace gfx
 {
     /* Uniform Buffer */
@@ -34,4 +37,46 @@ namespace gfx
     {
         m_uniformBuffers[frame][set][uniformBuffer->GetBinding()] = std::move(uniformBuffer);
     }
+
+    /* Transient Uniform Allocator */
+
+    TransientUniformAllocator::TransientUniformAllocator(const size_t sizePerFrame, const size_t alignment, const uint32_t frames)
+        : m_alignment(alignment),
+          m_frameSize((sizePerFrame + alignment - 1) & ~(alignment - 1))
+    {
+        m_buffer = Buffer::CreateUniform(m_frameSize * frames);
+        m_mapped = static_cast<uint8_t*>(m_buffer->GetMappedData());
+        GFX_ASSERT(m_mapped != nullptr, "Transient uniform buffer is not host visible!");
+    }
+
+    auto TransientUniformAllocator::Allocate(const size_t size) -> Allocation
+    {
+        const auto alignedSize = (size + m_alignment - 1) & ~(m_alignment - 1);
+        const auto offset = m_head.fetch_add(alignedSize);
+        if (offset + size > m_frameSize)
+        {
+            // Reported once per frame, every allocation after the first failing one fails as well
+            if (!m_overflowReported.exchange(true))
+                GFX_ERROR("Out of transient uniform memory, increase Config::TransientUniformSize!");
+            return {};
+        }
+
+        Allocation allocation{};
+        allocation.Offset = uint32_t(m_frameOffset + offset);
+        allocation.Data = m_mapped + m_frameOffset + offset;
+        return allocation;
+    }
+
+    void TransientUniformAllocator::Reset(const uint32_t frameIndex)
+    {
+        m_frameOffset = m_frameSize * frameIndex;
+        m_head = 0;
+        m_overflowReported = false;
+    }
+
+    void TransientUniformAllocator::Flush()
+    {
+        const auto used = std::min(m_head.load(), m_frameSize);
+        if (used != 0) m_buffer->Flush(m_frameOffset, used);
+    }
 }  // namespace gfx
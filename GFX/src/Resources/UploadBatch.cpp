@@ -0,0 +1,19 @@
+#include "GFX/Resources/UploadBatch.h"
+
+#include "GFX/Core/GFXCore.h"
+#include "Platform/Vulkan/VulkanUploadBatch.h"
+
+namespace gfx
+{
+    auto UploadBatch::Create() -> OwnedPtr<UploadBatch>
+    {
+        auto backendType = gfx::GetBackendType();
+        switch (backendType)
+        {
+            case BackendType::eVulkan: return CreateOwned<VulkanUploadBatch>();
+            case BackendType::eNone:
+            default: break;
+        }
+        return nullptr;
+    }
+}
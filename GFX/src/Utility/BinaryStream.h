@@ -0,0 +1,101 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace gfx
+{
+    // Little helpers for the small binary files GFX caches on disk. Values are written in native byte order, every file
+    // starts with a magic and version so data from another version or platform is rejected.
+    class BinaryWriter
+    {
+    public:
+        void Write(uint32_t value) { Write(&value, sizeof(value)); }
+        void Write(float value) { Write(std::bit_cast<uint32_t>(value)); }
+        void Write(const std::string& str)
+        {
+            Write(uint32_t(str.size()));
+            Write(str.data(), str.size());
+        }
+        void Write(const std::vector<uint8_t>& bytes)
+        {
+            Write(uint32_t(bytes.size()));
+            Write(bytes.data(), bytes.size());
+        }
+
+        auto GetData() -> std::vector<uint8_t>& { return m_data; }
+
+    private:
+        void Write(const void* data, size_t size)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            m_data.insert(m_data.end(), bytes, bytes + size);
+        }
+
+    private:
+        std::vector<uint8_t> m_data;
+    };
+
+    // Every read fails once the data runs out, so a truncated file is detected by checking the last read
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const std::vector<uint8_t>& data) : m_data(data) {}
+
+        bool Read(uint32_t& value) { return Read(&value, sizeof(value)); }
+        bool Read(float& value)
+        {
+            uint32_t bits = 0;
+            if (!Read(bits)) return false;
+
+            value = std::bit_cast<float>(bits);
+            return true;
+        }
+        bool Read(std::string& str)
+        {
+            uint32_t size = 0;
+            if (!Read(size) || size > m_data.size() - m_offset) return false;
+
+            str.assign(reinterpret_cast<const char*>(m_data.data() + m_offset), size);
+            m_offset += size;
+            return true;
+        }
+        bool Read(std::vector<uint8_t>& bytes)
+        {
+            uint32_t size = 0;
+            if (!Read(size) || size > m_data.size() - m_offset) return false;
+
+            bytes.assign(m_data.begin() + std::ptrdiff_t(m_offset), m_data.begin() + std::ptrdiff_t(m_offset + size));
+            m_offset += size;
+            return true;
+        }
+
+        // Reads the element count of an array, failing if that many elements of at least minElementSize bytes can not fit in
+        // the remaining data. Checked before anything is allocated, so a corrupt count never turns into a huge allocation.
+        bool ReadCount(uint32_t& count, size_t minElementSize)
+        {
+            if (!Read(count)) return false;
+
+            return size_t(count) <= (m_data.size() - m_offset) / minElementSize;
+        }
+
+        bool IsAtEnd() const { return m_offset == m_data.size(); }
+
+    private:
+        bool Read(void* data, size_t size)
+        {
+            if (size > m_data.size() - m_offset) return false;
+
+            std::memcpy(data, m_data.data() + m_offset, size);
+            m_offset += size;
+            return true;
+        }
+
+    private:
+        const std::vector<uint8_t>& m_data;
+        size_t m_offset = 0;
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define GFX_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define GFX_SSE2 0
+#endif
+
+namespace gfx
+{
+    // Four floats processed together, one SSE2 register where available. Used by the CPU texture processing, which works
+    // on RGBA texels.
+    struct Float4
+    {
+#if GFX_SSE2
+        __m128 V;
+
+        static auto Load(const float* values) -> Float4 { return { _mm_loadu_ps(values) }; }
+        static auto Splat(float value) -> Float4 { return { _mm_set1_ps(value) }; }
+        static auto Set(float x, float y, float z, float w) -> Float4 { return { _mm_setr_ps(x, y, z, w) }; }
+
+        void Store(float* values) const { _mm_storeu_ps(values, V); }
+
+        auto operator+(const Float4& other) const -> Float4 { return { _mm_add_ps(V, other.V) }; }
+        auto operator-(const Float4& other) const -> Float4 { return { _mm_sub_ps(V, other.V) }; }
+        auto operator*(const Float4& other) const -> Float4 { return { _mm_mul_ps(V, other.V) }; }
+        auto operator*(float value) const -> Float4 { return { _mm_mul_ps(V, _mm_set1_ps(value)) }; }
+
+        friend auto Min(const Float4& a, const Float4& b) -> Float4 { return { _mm_min_ps(a.V, b.V) }; }
+        friend auto Max(const Float4& a, const Float4& b) -> Float4 { return { _mm_max_ps(a.V, b.V) }; }
+
+        friend auto Dot(const Float4& a, const Float4& b) -> float
+        {
+            const __m128 product = _mm_mul_ps(a.V, b.V);
+            const __m128 sum = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtss_f32(_mm_add_ss(sum, _mm_movehl_ps(sum, sum)));
+        }
+#else
+        float V[4];
+
+        static auto Load(const float* values) -> Float4 { return { { values[0], values[1], values[2], values[3] } }; }
+        static auto Splat(float value) -> Float4 { return { { value, value, value, value } }; }
+        static auto Set(float x, float y, float z, float w) -> Float4 { return { { x, y, z, w } }; }
+
+        void Store(float* values) const { std::copy(V, V + 4, values); }
+
+        auto operator+(const Float4& other) const -> Float4 { return { { V[0] + other.V[0], V[1] + other.V[1], V[2] + other.V[2], V[3] + other.V[3] } }; }
+        auto operator-(const Float4& other) const -> Float4 { return { { V[0] - other.V[0], V[1] - other.V[1], V[2] - other.V[2], V[3] - other.V[3] } }; }
+        auto operator*(const Float4& other) const -> Float4 { return { { V[0] * other.V[0], V[1] * other.V[1], V[2] * other.V[2], V[3] * other.V[3] } }; }
+        auto operator*(float value) const -> Float4 { return { { V[0] * value, V[1] * value, V[2] * value, V[3] * value } }; }
+
+        friend auto Min(const Float4& a, const Float4& b) -> Float4
+        {
+            return { { std::min(a.V[0], b.V[0]), std::min(a.V[1], b.V[1]), std::min(a.V[2], b.V[2]), std::min(a.V[3], b.V[3]) } };
+        }
+        friend auto Max(const Float4& a, const Float4& b) -> Float4
+        {
+            return { { std::max(a.V[0], b.V[0]), std::max(a.V[1], b.V[1]), std::max(a.V[2], b.V[2]), std::max(a.V[3], b.V[3]) } };
+        }
+
+        friend auto Dot(const Float4& a, const Float4& b) -> float { return a.V[0] * b.V[0] + a.V[1] * b.V[1] + a.V[2] * b.V[2] + a.V[3] * b.V[3]; }
+#endif
+
+        auto operator+=(const Float4& other) -> Float4& { return *this = *this + other; }
+        auto operator-=(const Float4& other) -> Float4& { return *this = *this - other; }
+
+        auto operator[](int index) const -> float
+        {
+            float values[4];
+            Store(values);
+            return values[index];
+        }
+    };
+}
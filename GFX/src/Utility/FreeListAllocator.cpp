@@ -0,0 +1,83 @@
+#include "FreeListAllocator.h"
+
+#include "GFX/Debug.h"
+
+namespace gfx
+{
+    FreeListAllocator::FreeListAllocator(const uint32_t size)
+        : m_size(size),
+          m_freeSpace(size)
+    {
+        if (size > 0) AddBlock(0, size);
+    }
+
+    auto FreeListAllocator::Allocate(const uint32_t size) -> uint32_t
+    {
+        if (size == 0) return InvalidOffset;
+
+        const auto sizeIt = m_blocksBySize.lower_bound(size);
+        if (sizeIt == m_blocksBySize.end()) return InvalidOffset;
+
+        const auto blockSize = sizeIt->first;
+        const auto offset = sizeIt->second;
+        RemoveBlock(m_blocksByOffset.find(offset));
+
+        // Return the tail of the block to the free list
+        if (blockSize > size) AddBlock(offset + size, blockSize - size);
+
+        m_freeSpace -= size;
+        return offset;
+    }
+
+    void FreeListAllocator::Free(uint32_t offset, uint32_t size)
+    {
+        if (size == 0) return;
+
+        GFX_ASSERT(offset + size <= m_size, "Freed range is out of bounds!");
+        m_freeSpace += size;
+
+        // Merge with the following block
+        const auto nextIt = m_blocksByOffset.find(offset + size);
+        if (nextIt != m_blocksByOffset.end())
+        {
+            size += nextIt->second;
+            RemoveBlock(nextIt);
+        }
+
+        // Merge with the preceding block
+        auto prevIt = m_blocksByOffset.lower_bound(offset);
+        if (prevIt != m_blocksByOffset.begin())
+        {
+            --prevIt;
+            if (prevIt->first + prevIt->second == offset)
+            {
+                offset = prevIt->first;
+                size += prevIt->second;
+                RemoveBlock(prevIt);
+            }
+        }
+
+        AddBlock(offset, size);
+    }
+
+    void FreeListAllocator::AddBlock(const uint32_t offset, const uint32_t size)
+    {
+        m_blocksByOffset.emplace(offset, size);
+        m_blocksBySize.emplace(size, offset);
+    }
+
+    void FreeListAllocator::RemoveBlock(const std::map<uint32_t, uint32_t>::iterator it)
+    {
+        auto [begin, end] = m_blocksBySize.equal_range(it->second);
+        for (auto sizeIt = begin; sizeIt != end; ++sizeIt)
+        {
+            if (sizeIt->second == it->first)
+            {
+                m_blocksBySize.erase(sizeIt);
+                break;
+            }
+        }
+
+        m_blocksByOffset.erase(it);
+    }
+}
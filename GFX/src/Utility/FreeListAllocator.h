@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+namespace gfx
+{
+    // Hands out ranges of an abstract [0, size) address space. Picks the smallest free block that fits and merges
+    // neighbouring blocks again when they are freed.
+    class FreeListAllocator
+    {
+    public:
+        static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+        FreeListAllocator(uint32_t size);
+
+        auto GetSize() const -> uint32_t { return m_size; }
+        auto GetFreeSpace() const -> uint32_t { return m_freeSpace; }
+
+        // Returns InvalidOffset if no free block is large enough
+        auto Allocate(uint32_t size) -> uint32_t;
+        void Free(uint32_t offset, uint32_t size);
+
+    private:
+        void AddBlock(uint32_t offset, uint32_t size);
+        void RemoveBlock(std::map<uint32_t, uint32_t>::iterator it);
+
+    private:
+        uint32_t m_size;
+        uint32_t m_freeSpace;
+
+        std::map<uint32_t, uint32_t> m_blocksByOffset;       // offset -> size
+        std::multimap<uint32_t, uint32_t> m_blocksBySize;    // size -> offset
+    };
+}
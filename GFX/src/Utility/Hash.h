@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace gfx
+{
+    // 64-bit FNV-1a. Unlike std::hash the result is stable across runs and platforms, so it can key on-disk caches.
+    constexpr uint64_t HashSeed = 0xcbf29ce484222325ull;
+
+    inline auto HashBytes(const void* data, size_t size, uint64_t hash = HashSeed) -> uint64_t
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // Only for types without padding, e.g. integers and enums
+    template <typename T>
+    inline auto HashValue(const T& value, uint64_t hash = HashSeed) -> uint64_t
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return HashBytes(&value, sizeof(T), hash);
+    }
+
+    inline auto HashString(std::string_view str, uint64_t hash = HashSeed) -> uint64_t
+    {
+        // Include the length so consecutive strings cannot shift into each other
+        hash = HashValue(str.size(), hash);
+        return HashBytes(str.data(), str.size(), hash);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace gfx
+{
+    // Calls `fn(i)` for every i in [0, count) across up to hardware_concurrency() threads, the calling thread
+    // included. Returns once every call has finished.
+    template <typename Fn>
+    void ParallelFor(uint32_t count, Fn&& fn)
+    {
+        const uint32_t threadCount = std::min(count, std::max(1u, std::thread::hardware_concurrency()));
+        if (threadCount <= 1)
+        {
+            for (uint32_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+
+        std::atomic<uint32_t> next = 0;
+        auto worker = [&]()
+        {
+            for (uint32_t i = next++; i < count; i = next++) fn(i);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (uint32_t i = 0; i < threadCount - 1; i++)
+        {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
@@ -0,0 +1,111 @@
+//
+// Measures CPU block compression throughput for every compressed format and quality, on an image passed on the command line
+// or a generated one
+//
+
+#include <ExampleBase/ExampleBase.h>
+
+#include <GFX/GFX.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+constexpr uint32_t GeneratedSize = 2048;
+constexpr uint32_t MeasuredRuns = 3;
+
+// Smooth gradients with hard edged tiles and noisy alpha, so no format gets away with trivial blocks
+auto GenerateImage(uint32_t width, uint32_t height) -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> data(size_t(width) * height * 4);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            uint8_t* texel = &data[(size_t(y) * width + x) * 4];
+            texel[0] = uint8_t(127.5f + 127.5f * std::sin(float(x) * 0.02f) * std::cos(float(y) * 0.013f));
+            texel[1] = uint8_t((x * 255) / width);
+            texel[2] = ((x / 64) + (y / 64)) % 2 == 0 ? uint8_t(40) : uint8_t(220);
+            texel[3] = uint8_t((x ^ y) & 0xFF);
+        }
+    }
+    return data;
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "Running example \"BenchmarkCompression\"" << std::endl;
+
+    gfx::SetDebugCallback([](gfx::DebugLevel level, std::string msg)
+    {
+        if (level <= gfx::DebugLevel::eWarn)
+            std::cout << "[GFX] " << msg << std::endl;
+        else
+            std::cerr << "[GFX] " << msg << std::endl;
+    });
+
+    uint32_t width = GeneratedSize;
+    uint32_t height = GeneratedSize;
+    std::vector<uint8_t> data;
+    if (argc > 1)
+    {
+        gfx::TextureImporter importer(argv[1]);
+        if (importer.GetData().empty() || importer.GetFormat() != gfx::TextureFormat::eRGBA)
+        {
+            std::cerr << "Failed to load an 8-bit image from \"" << argv[1] << "\"" << std::endl;
+            return 1;
+        }
+        width = importer.GetWidth();
+        height = importer.GetHeight();
+        data = importer.GetData();
+    }
+    else
+    {
+        data = GenerateImage(width, height);
+    }
+
+    const struct
+    {
+        const char* Name;
+        gfx::TextureFormat Format;
+    } formats[] = {
+        { "BC1", gfx::TextureFormat::eBC1 }, { "BC3", gfx::TextureFormat::eBC3 }, { "BC4", gfx::TextureFormat::eBC4 },
+        { "BC5", gfx::TextureFormat::eBC5 }, { "BC7", gfx::TextureFormat::eBC7 },
+    };
+    const struct
+    {
+        const char* Name;
+        gfx::CompressionQuality Quality;
+    } qualities[] = {
+        { "Fast", gfx::CompressionQuality::eFast },
+        { "Normal", gfx::CompressionQuality::eNormal },
+        { "High", gfx::CompressionQuality::eHigh },
+    };
+
+    const double megapixels = double(width) * height / 1e6;
+    std::printf("Compressing %ux%u, best of %u runs\n", width, height, MeasuredRuns);
+    std::printf("%8s %8s %12s %10s\n", "Format", "Quality", "Time (ms)", "MP/s");
+
+    for (const auto& format : formats)
+    {
+        for (const auto& quality : qualities)
+        {
+            double bestTime = 0.0;
+            for (uint32_t run = 0; run < MeasuredRuns; run++)
+            {
+                const auto start = std::chrono::high_resolution_clock::now();
+                const auto compressed = gfx::CompressTexture(data, width, height, gfx::TextureFormat::eRGBA, format.Format, quality.Quality);
+                const auto end = std::chrono::high_resolution_clock::now();
+
+                const double time = std::chrono::duration<double, std::milli>(end - start).count();
+                bestTime = run == 0 ? time : std::min(bestTime, time);
+            }
+
+            std::printf("%8s %8s %12.2f %10.1f\n", format.Name, quality.Name, bestTime, megapixels / (bestTime / 1000.0));
+        }
+    }
+
+    return 0;
+}
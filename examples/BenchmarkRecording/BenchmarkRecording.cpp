@@ -0,0 +1,316 @@
+//
+// Measures how command recording scales when draws are split across worker threads recording secondary command buffers
+//
+
+#include <ExampleBase/ExampleBase.h>
+
+#include <GFX/GFX.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct Vertex
+{
+    glm::vec3 Position;
+    glm::vec3 Color;
+};
+
+const std::vector<Vertex> triVerts = {
+    { { 0.0f, -0.01f, 0.0f }, { 1, 0, 0 } },
+    { { -0.01f, 0.01f, 0.0f }, { 0, 0, 1 } },
+    { { 0.01f, 0.01f, 0.0f }, { 0, 1, 0 } },
+};
+const std::vector<uint32_t> triIndices = { 0, 1, 2 };
+
+const std::string vertexSource = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec3 a_Color;
+
+layout(push_constant) uniform PushBlock
+{
+    vec2 offset;
+} pushBlock;
+
+struct VertexOutput
+{
+    vec4 Color;
+};
+
+layout (location = 0) out VertexOutput Output;
+
+void main()
+{
+    Output.Color = vec4(a_Color, 1.0f);
+
+    gl_Position = vec4(a_Position.xy + pushBlock.offset, a_Position.z, 1.0f);
+}
+)";
+const std::string pixelSource = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (location = 0) out vec4 out_Color;
+
+struct VertexOutput
+{
+    vec4 Color;
+};
+
+layout(location = 0) in VertexOutput Input;
+
+void main()
+{
+    out_Color = Input.Color;
+}
+)";
+
+constexpr uint32_t DrawCount = 20000;
+constexpr uint32_t WarmUpFrames = 10;
+constexpr uint32_t MeasuredFrames = 100;
+
+struct RecordContext
+{
+    gfx::Framebuffer* Framebuffer = nullptr;
+    gfx::Pipeline* Pipeline = nullptr;
+    gfx::Buffer* VertexBuffer = nullptr;
+    gfx::Buffer* IndexBuffer = nullptr;
+    gfx::Viewport Viewport{};
+    gfx::Scissor Scissor{};
+};
+
+// Threads are started once, so the timed region measures recording rather than thread creation
+class WorkerPool
+{
+public:
+    WorkerPool(uint32_t threadCount)
+    {
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            m_threads.emplace_back([this, i]() { Run(i); });
+        }
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Runs `job(i)` on the first `count` workers and returns once all of them have finished
+    void Execute(uint32_t count, const std::function<void(uint32_t)>& job)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_job = &job;
+            m_jobCount = count;
+            m_pending = count;
+            m_generation++;
+        }
+        m_start.notify_all();
+
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [&]() { return m_pending == 0; });
+    }
+
+private:
+    void Run(uint32_t index)
+    {
+        uint64_t generation = 0;
+        std::unique_lock lock(m_mutex);
+        while (true)
+        {
+            m_start.wait(lock, [&]() { return m_stop || m_generation != generation; });
+            if (m_stop) return;
+
+            generation = m_generation;
+            if (index >= m_jobCount) continue;
+
+            const auto* job = m_job;
+            lock.unlock();
+            (*job)(index);
+            lock.lock();
+
+            if (--m_pending == 0) m_done.notify_one();
+        }
+    }
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(uint32_t)>* m_job = nullptr;
+    uint32_t m_jobCount = 0;
+    uint32_t m_pending = 0;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+};
+
+void RecordDraws(gfx::CommandBuffer* cmdBuffer, const RecordContext& context, uint32_t firstDraw, uint32_t drawCount)
+{
+    cmdBuffer->Begin(context.Framebuffer);
+    cmdBuffer->SetViewport(context.Viewport);
+    cmdBuffer->SetScissor(context.Scissor);
+
+    cmdBuffer->BindPipeline(context.Pipeline);
+    cmdBuffer->BindVertexBuffer(context.VertexBuffer);
+    cmdBuffer->BindIndexBuffer(context.IndexBuffer);
+
+    constexpr uint32_t gridSize = 150;
+    for (uint32_t i = firstDraw; i < firstDraw + drawCount; i++)
+    {
+        const glm::vec2 offset = {
+            (float(i % gridSize) / gridSize) * 2.0f - 1.0f,
+            (float((i / gridSize) % gridSize) / gridSize) * 2.0f - 1.0f,
+        };
+        cmdBuffer->SetConstants(gfx::ShaderStage::eVertex, 0, sizeof(offset), &offset);
+        cmdBuffer->DrawIndexed(uint32_t(triIndices.size()), 1, 0, 0, 0);
+    }
+
+    cmdBuffer->End();
+}
+
+int main(int argc, char** argv)
+{
+    std::cout << "Running example \"BenchmarkRecording\"" << std::endl;
+
+    gfx::SetDebugCallback([](gfx::DebugLevel level, std::string msg)
+    {
+        if (level <= gfx::DebugLevel::eWarn)
+            std::cout << "[GFX] " << msg << std::endl;
+        else
+            std::cerr << "[GFX] " << msg << std::endl;
+    });
+
+    gfx::Init(gfx::BackendType::eVulkan);
+
+    {
+        gfx::Window window(720, 480, "Benchmark Recording");
+        auto framebuffer = gfx::Framebuffer::Create(window.GetSwapChain());
+
+        auto vertexBuffer = gfx::Buffer::CreateVertex(sizeof(Vertex) * triVerts.size(), triVerts.data());
+        auto indexBuffer = gfx::Buffer::CreateIndex(sizeof(uint32_t) * triIndices.size(), triIndices.data());
+
+        auto shader = gfx::Shader::Create(vertexSource, pixelSource);
+
+        gfx::PipelineDesc pipelineDesc{};
+        pipelineDesc.Framebuffer = framebuffer.get();
+        pipelineDesc.Shader = shader.get();
+        pipelineDesc.Layout = {
+            { gfx::ShaderDataType::Float3, "a_Position" },
+            { gfx::ShaderDataType::Float3, "a_Color" },
+        };
+        auto pipeline = gfx::Pipeline::Create(pipelineDesc);
+
+        RecordContext context{};
+        context.Framebuffer = framebuffer.get();
+        context.Pipeline = pipeline.get();
+        context.VertexBuffer = vertexBuffer.get();
+        context.IndexBuffer = indexBuffer.get();
+        context.Viewport.Width = window.GetWidth();
+        context.Viewport.Height = window.GetHeight();
+        context.Scissor.Width = window.GetWidth();
+        context.Scissor.Height = window.GetHeight();
+
+        const uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+        // One secondary command buffer, and with it one command pool, per worker thread
+        std::vector<gfx::OwnedPtr<gfx::CommandBuffer>> secondaryCmdBuffers;
+        for (uint32_t i = 0; i < maxThreads; i++)
+        {
+            secondaryCmdBuffers.push_back(gfx::CommandBuffer::CreateSecondary());
+        }
+
+        std::vector<uint32_t> threadCounts;
+        for (uint32_t threadCount = 1; threadCount < maxThreads; threadCount *= 2)
+        {
+            threadCounts.push_back(threadCount);
+        }
+        threadCounts.push_back(maxThreads);
+
+        WorkerPool workerPool(maxThreads);
+
+        std::printf("Recording %u draws, %u measured frames per run\n", DrawCount, MeasuredFrames);
+        std::printf("%8s %14s %10s\n", "Threads", "Record (ms)", "Speedup");
+
+        auto cmdBuffer = gfx::CommandBuffer::Create();
+        double singleThreadedTime = 0.0;
+        for (const auto threadCount : threadCounts)
+        {
+            std::vector<gfx::CommandBuffer*> executeCmdBuffers;
+            for (uint32_t i = 0; i < threadCount; i++)
+            {
+                executeCmdBuffers.push_back(secondaryCmdBuffers[i].get());
+            }
+
+            double totalTime = 0.0;
+            uint32_t measuredFrames = 0;
+            for (uint32_t frame = 0; frame < WarmUpFrames + MeasuredFrames && !window.IsCloseRequested(); frame++)
+            {
+                window.PollEvents();
+                window.GetSwapChain()->NewFrame();
+
+                cmdBuffer->Begin();
+
+                const auto start = std::chrono::high_resolution_clock::now();
+
+                const uint32_t drawsPerThread = (DrawCount + threadCount - 1) / threadCount;
+                workerPool.Execute(threadCount,
+                                   [&](uint32_t i)
+                                   {
+                                       const uint32_t firstDraw = std::min(i * drawsPerThread, DrawCount);
+                                       const uint32_t drawCount = std::min(drawsPerThread, DrawCount - firstDraw);
+                                       RecordDraws(executeCmdBuffers[i], context, firstDraw, drawCount);
+                                   });
+
+                cmdBuffer->BeginRenderPass(framebuffer.get(), true);
+                cmdBuffer->ExecuteCommands(executeCmdBuffers);
+                cmdBuffer->EndRenderPass();
+                cmdBuffer->End();
+
+                // Recording of the secondaries and of the primary executing them. Present() is excluded, it can block on
+                // vsync, as is the wait for an earlier frame in NewFrame().
+                const auto end = std::chrono::high_resolution_clock::now();
+                if (frame >= WarmUpFrames)
+                {
+                    totalTime += std::chrono::duration<double, std::milli>(end - start).count();
+                    measuredFrames++;
+                }
+
+                window.GetSwapChain()->Present(cmdBuffer.get());
+            }
+
+            // A run cut short by closing the window still reports the frames it measured
+            if (measuredFrames == 0) break;
+
+            const double averageTime = totalTime / measuredFrames;
+            if (threadCount == 1) singleThreadedTime = averageTime;
+
+            std::printf("%8u %14.3f %9.2fx\n", threadCount, averageTime, singleThreadedTime / averageTime);
+
+            if (window.IsCloseRequested()) break;
+        }
+    }
+    gfx::Shutdown();
+
+    return 0;
+}